@@ -0,0 +1,24 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#if WITH_TEXT_ARCHIVE_SUPPORT
+#include "Formatters/JsonOutputArchiveFormatter.h"
+#include "Formatters/NullArchiveFormatter.h"
+#include "Formatters/ProxyArchiveFormatter.h"
+#include "Formatters/BinaryArchiveFormatter.h"
+
+/** Writes to the binary archive, while also building a JSON document of the same data (unless using null, i.e. when loading) */
+class FSaveGameArchiveFormatter : public FProxyArchiveFormatter
+{
+public:
+	FSaveGameArchiveFormatter(FArchive& InnerArchive, bool bUseNull)
+		: FProxyArchiveFormatter(BinaryFormatter,
+			static_cast<FStructuredArchiveFormatter&>(bUseNull ? FNullArchiveFormatter::Get() : JsonFormatter))
+		, BinaryFormatter(InnerArchive)
+	{}
+
+	FBinaryArchiveFormatter BinaryFormatter;
+	FJsonOutputArchiveFormatter JsonFormatter;
+};
+#endif
@@ -0,0 +1,125 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameActorRegistry.h"
+
+void FSaveGameActorRegistry::Add(AActor* Actor)
+{
+	check(Actor);
+
+	const int32 ObjectIndex = Actor->GetUniqueID();
+
+	if (!ActorSlots.IsValidIndex(ObjectIndex))
+	{
+		// Grow a little extra, as spawned actors are likely to be given the next few indices
+		const int32 OldNum = ActorSlots.Num();
+		ActorSlots.SetNum(FMath::Max(ObjectIndex + 1, OldNum + OldNum / 2));
+	}
+
+	FSlot& Slot = ActorSlots[ObjectIndex];
+
+	if (Slot.Bucket != INDEX_NONE)
+	{
+		const TWeakObjectPtr<AActor>& Existing = Buckets[Slot.Bucket].Actors[Slot.Index];
+
+		if (Existing.Get(true) == Actor)
+		{
+			return;
+		}
+
+		// The UObject index was recycled from an actor that was never unregistered, free its slot
+		Buckets[Slot.Bucket].Actors.RemoveAt(Slot.Index);
+		--NumActors;
+	}
+
+	Slot.Bucket = FindOrAddBucket(Actor->GetClass());
+	Slot.Index = Buckets[Slot.Bucket].Actors.Add(Actor);
+	++NumActors;
+}
+
+bool FSaveGameActorRegistry::Remove(const AActor* Actor)
+{
+	if (!Actor || !FindSlot(Actor))
+	{
+		return false;
+	}
+
+	FSlot& Slot = ActorSlots[Actor->GetUniqueID()];
+	Buckets[Slot.Bucket].Actors.RemoveAt(Slot.Index);
+	Slot = FSlot();
+	--NumActors;
+
+	return true;
+}
+
+bool FSaveGameActorRegistry::Contains(const AActor* Actor) const
+{
+	return Actor && FindSlot(Actor);
+}
+
+void FSaveGameActorRegistry::Reset()
+{
+	Buckets.Reset();
+	ClassBuckets.Reset();
+	ActorSlots.Reset();
+	NumActors = 0;
+}
+
+void FSaveGameActorRegistry::GetActors(TArray<TWeakObjectPtr<AActor>>& OutActors) const
+{
+	OutActors.Reset(NumActors);
+
+	for (const FClassBucket& Bucket : Buckets)
+	{
+		for (const TWeakObjectPtr<AActor>& Actor : Bucket.Actors)
+		{
+			OutActors.Add(Actor);
+		}
+	}
+}
+
+int32 FSaveGameActorRegistry::FindOrAddBucket(UClass* Class)
+{
+	const int32 ClassIndex = Class->GetUniqueID();
+
+	if (!ClassBuckets.IsValidIndex(ClassIndex))
+	{
+		const int32 OldNum = ClassBuckets.Num();
+		ClassBuckets.SetNumUninitialized(ClassIndex + 1);
+
+		for (int32 Idx = OldNum; Idx < ClassBuckets.Num(); ++Idx)
+		{
+			ClassBuckets[Idx] = INDEX_NONE;
+		}
+	}
+
+	int32& BucketIdx = ClassBuckets[ClassIndex];
+
+	// Also check the class, in case a recycled UObject index is now used by a different class
+	if (BucketIdx == INDEX_NONE || Buckets[BucketIdx].Class.Get() != Class)
+	{
+		BucketIdx = Buckets.AddDefaulted();
+		Buckets[BucketIdx].Class = Class;
+	}
+
+	return BucketIdx;
+}
+
+const FSaveGameActorRegistry::FSlot* FSaveGameActorRegistry::FindSlot(const AActor* Actor) const
+{
+	const int32 ObjectIndex = Actor->GetUniqueID();
+
+	if (!ActorSlots.IsValidIndex(ObjectIndex))
+	{
+		return nullptr;
+	}
+
+	const FSlot& Slot = ActorSlots[ObjectIndex];
+
+	// Compare against the stored actor too, as the UObject index may have been recycled
+	if (Slot.Bucket == INDEX_NONE || Buckets[Slot.Bucket].Actors[Slot.Index].Get(true) != Actor)
+	{
+		return nullptr;
+	}
+
+	return &Slot;
+}
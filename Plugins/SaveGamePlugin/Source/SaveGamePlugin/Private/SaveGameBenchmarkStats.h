@@ -0,0 +1,29 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+
+/** Measurements shared by the benchmark commandlet and tests */
+namespace SaveGameBenchmarkStats
+{
+	/** The allocator only counts its calls when stats are enabled */
+	constexpr bool bCountsAllocations = STATS != 0;
+
+	/** Total calls to Malloc and Realloc across all threads, or zero if the allocator doesn't count them */
+	inline uint64 GetNumAllocations()
+	{
+#if STATS
+		return FMalloc::TotalMallocCalls + FMalloc::TotalReallocCalls;
+#else
+		return 0;
+#endif
+	}
+
+	inline double GetMedian(TArray<double> Samples)
+	{
+		Samples.Sort();
+		return Samples[(Samples.Num() - 1) / 2];
+	}
+}
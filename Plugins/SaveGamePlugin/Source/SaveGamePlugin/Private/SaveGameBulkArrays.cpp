@@ -0,0 +1,140 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameBulkArrays.h"
+
+#include "SaveGameColumns.h"
+
+#include "Algo/Reverse.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSaveGameBulkArrays, Log, All);
+
+namespace SaveGameBulkArrays
+{
+	/** Reverses the bytes of each element in place */
+	void SwapElementBytes(uint8* Data, int32 NumElements, int32 ElementSize)
+	{
+		for (int32 ElementIdx = 0; ElementIdx < NumElements; ++ElementIdx)
+		{
+			uint8* Element = Data + ElementIdx * ElementSize;
+			Algo::Reverse(Element, ElementSize);
+		}
+	}
+}
+
+bool FSaveGameBulkArrays::CanStoreInBulk(const FProperty* Property)
+{
+	// The same elements as columns, as both are copied as raw memory
+	const FArrayProperty* ArrayProperty = CastField<FArrayProperty>(Property);
+	return ArrayProperty && ArrayProperty->ArrayDim == 1 && FSaveGameColumns::CanStoreAsColumn(ArrayProperty->Inner);
+}
+
+void FSaveGameBulkArrays::GetProperties(const UClass* Class, TArray<const FProperty*>& OutProperties)
+{
+	OutProperties.Reset();
+
+	for (TFieldIterator<FProperty> It(Class); It; ++It)
+	{
+		if (It->HasAnyPropertyFlags(CPF_SaveGame) && CanStoreInBulk(*It))
+		{
+			OutProperties.Add(*It);
+		}
+	}
+}
+
+void FSaveGameBulkArrays::Serialize(FStructuredArchive::FSlot Slot, UObject* Object, TConstArrayView<const FProperty*> Properties)
+{
+	using namespace SaveGameBulkArrays;
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_SerializeBulkArrays);
+
+	FArchive& Archive = Slot.GetUnderlyingArchive();
+	const bool bIsLoading = Archive.IsLoading();
+	FStructuredArchive::FRecord Record = Slot.EnterRecord();
+
+	bool bIsLittleEndian = PLATFORM_LITTLE_ENDIAN;
+	Record << SA_VALUE(TEXT("LittleEndian"), bIsLittleEndian);
+
+	int32 NumArrays = Properties.Num();
+	FStructuredArchive::FArray Arrays = Record.EnterArray(TEXT("Arrays"), NumArrays);
+
+	for (int32 ArrayIdx = 0; ArrayIdx < NumArrays; ++ArrayIdx)
+	{
+		FStructuredArchive::FRecord ArrayRecord = Arrays.EnterElement().EnterRecord();
+
+		const FArrayProperty* ArrayProperty = nullptr;
+		FName Name;
+		FName Type;
+		int32 ElementSize = 0;
+		int32 Num = 0;
+
+		if (!bIsLoading)
+		{
+			ArrayProperty = CastFieldChecked<const FArrayProperty>(Properties[ArrayIdx]);
+			Name = ArrayProperty->GetFName();
+			Type = FSaveGameColumns::GetColumnType(ArrayProperty->Inner);
+			ElementSize = ArrayProperty->Inner->GetSize();
+			Num = FScriptArrayHelper(ArrayProperty, ArrayProperty->ContainerPtrToValuePtr<void>(Object)).Num();
+		}
+
+		ArrayRecord << SA_VALUE(TEXT("Name"), Name);
+		ArrayRecord << SA_VALUE(TEXT("Type"), Type);
+		ArrayRecord << SA_VALUE(TEXT("ElementSize"), ElementSize);
+		ArrayRecord << SA_VALUE(TEXT("Num"), Num);
+
+		// Sizes are read from the save, so they're only trusted if the data could actually be there
+		const int64 NumBytes = static_cast<int64>(Num) * ElementSize;
+
+		if (bIsLoading)
+		{
+			const bool bIsValidSize = Num >= 0 && ElementSize > 0 && NumBytes <= MAX_int32
+				&& (Archive.IsTextFormat() || NumBytes <= Archive.TotalSize() - Archive.Tell());
+
+			if (!bIsValidSize)
+			{
+				// We can't tell where this array's data ends, so neither can we read anything after it
+				UE_LOG(LogSaveGameBulkArrays, Error, TEXT("Array %s of %s has an invalid size (%d elements of %d bytes), so the rest of its arrays won't be loaded"),
+					*Name.ToString(), *GetNameSafe(Object), Num, ElementSize);
+				Archive.SetError();
+				return;
+			}
+
+			const FProperty* const* FoundProperty = Properties.FindByPredicate([Name](const FProperty* Property) { return Property->GetFName() == Name; });
+			ArrayProperty = FoundProperty ? CastField<FArrayProperty>(*FoundProperty) : nullptr;
+
+			const bool bIsStruct = ArrayProperty && ArrayProperty->Inner->IsA<FStructProperty>();
+			const bool bMatches = ArrayProperty
+				&& FSaveGameColumns::GetColumnType(ArrayProperty->Inner) == Type
+				&& ArrayProperty->Inner->GetSize() == ElementSize
+				&& (bIsLittleEndian == PLATFORM_LITTLE_ENDIAN || !bIsStruct);
+
+			UE_CLOG(!bMatches, LogSaveGameBulkArrays, Warning, TEXT("Array %s of %s no longer matches its property, so won't be loaded"),
+				*Name.ToString(), *GetNameSafe(Object));
+
+			if (!bMatches)
+			{
+				// We still need to read past its data
+				TArray<uint8> SkippedData;
+				SkippedData.SetNumUninitialized(static_cast<int32>(NumBytes));
+				ArrayRecord.EnterField(TEXT("Data")).Serialize(SkippedData.GetData(), SkippedData.Num());
+				continue;
+			}
+		}
+
+		FScriptArrayHelper ArrayHelper(ArrayProperty, ArrayProperty->ContainerPtrToValuePtr<void>(Object));
+
+		if (bIsLoading)
+		{
+			// These elements are plain old data, so they don't need to be constructed before being copied over
+			ArrayHelper.EmptyAndAddUninitializedValues(Num);
+		}
+
+		// A single copy, rather than going through each element's tagged property
+		uint8* Data = Num > 0 ? ArrayHelper.GetRawPtr() : nullptr;
+		ArrayRecord.EnterField(TEXT("Data")).Serialize(Data, NumBytes);
+
+		if (bIsLoading && bIsLittleEndian != PLATFORM_LITTLE_ENDIAN && ElementSize > 1)
+		{
+			SwapElementBytes(Data, Num, ElementSize);
+		}
+	}
+}
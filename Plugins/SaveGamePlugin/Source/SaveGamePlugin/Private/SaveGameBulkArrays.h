@@ -0,0 +1,29 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * SaveGame arrays of bools, numbers, enums or plain old data structs, stored as one block of memory per array
+ * rather than as tagged properties, so that they're a single copy to save or load regardless of their length.
+ *
+ * These arrays are skipped when the rest of an object's SaveGame properties are serialized (see
+ * TSaveGameProxyArchive::SetSkippedProperties), and written straight after them. Like FSaveGameColumns, arrays are
+ * matched to properties by name, type and element size when loading, so changed arrays are skipped. Numbers and enums
+ * are byte swapped if the save was made on a platform with a different endianness, structs are skipped.
+ *
+ * Structs with padding (or with members that aren't properties) aren't stored in bulk, as copying their bytes would
+ * also copy whatever happened to be in the padding, so saves of the same world would no longer be byte-identical.
+ */
+class FSaveGameBulkArrays
+{
+public:
+	static bool CanStoreInBulk(const FProperty* Property);
+
+	/** Gets the class's SaveGame properties that can be stored in bulk, see FSaveGameClassTraits::BulkArrayProperties for the cached list */
+	static void GetProperties(const UClass* Class, TArray<const FProperty*>& OutProperties);
+
+	/** Saves the object's arrays of these properties, or loads the arrays that still match one of them */
+	static void Serialize(FStructuredArchive::FSlot Slot, UObject* Object, TConstArrayView<const FProperty*> Properties);
+};
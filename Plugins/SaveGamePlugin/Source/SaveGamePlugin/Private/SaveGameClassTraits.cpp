@@ -0,0 +1,91 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameClassTraits.h"
+
+#include "SaveGameBulkArrays.h"
+#include "SaveGameColumns.h"
+#include "SaveGameObject.h"
+#include "SaveGameSettings.h"
+
+#include "UObject/ObjectKey.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSaveGameClassTraits, Log, All);
+
+static FRWLock GSaveGameClassTraitsLock;
+static TMap<TObjectKey<UClass>, FSaveGameClassTraits> GSaveGameClassTraits;
+
+static bool IsColumnarClass(const UClass* Class)
+{
+	const FSoftObjectPath ClassPath(Class);
+	const TArray<TSoftClassPtr<AActor>>& ColumnarClasses = GetDefault<USaveGameSettings>()->ColumnarClasses;
+
+	if (!ColumnarClasses.ContainsByPredicate([&ClassPath](const TSoftClassPtr<AActor>& ColumnarClass) { return ColumnarClass.ToSoftObjectPath() == ClassPath; }))
+	{
+		return false;
+	}
+
+	for (TFieldIterator<FProperty> It(Class); It; ++It)
+	{
+		if (It->HasAnyPropertyFlags(CPF_SaveGame) && !FSaveGameColumns::CanStoreAsColumn(*It))
+		{
+			UE_LOG(LogSaveGameClassTraits, Warning, TEXT("%s can't be columnar, as its SaveGame property %s isn't a bool, number, enum or plain old data struct without padding"),
+				*Class->GetPathName(), *It->GetName());
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static FSaveGameClassTraits BuildClassTraits(const UClass* Class)
+{
+	FSaveGameClassTraits Traits;
+	Traits.bIsSaveGameObject = Class->ImplementsInterface(USaveGameObject::StaticClass());
+	Traits.bIsSpawnActor = Class->ImplementsInterface(USaveGameSpawnActor::StaticClass());
+
+	if (Traits.bIsSaveGameObject)
+	{
+		// IsThreadSafe should only ever return a constant, so the CDO's answer applies to every instance
+		Traits.bIsThreadSafe = ISaveGameObject::Execute_IsThreadSafe(Class->GetDefaultObject());
+	}
+
+	Traits.bIsColumnar = IsColumnarClass(Class);
+
+	TArray<const FProperty*> BulkArrayProperties;
+	FSaveGameBulkArrays::GetProperties(Class, BulkArrayProperties);
+	Traits.bHasBulkArrays = !BulkArrayProperties.IsEmpty();
+
+	if (Traits.bHasBulkArrays)
+	{
+		// Shared, so that an operation can keep using the list even if the cache is reset
+		Traits.BulkArrayProperties = MakeShared<const TArray<const FProperty*>>(MoveTemp(BulkArrayProperties));
+	}
+
+	return Traits;
+}
+
+FSaveGameClassTraits FSaveGameClassTraits::Get(const UClass* Class)
+{
+	check(Class);
+
+	{
+		FReadScopeLock ReadLock(GSaveGameClassTraitsLock);
+
+		if (const FSaveGameClassTraits* Traits = GSaveGameClassTraits.Find(Class))
+		{
+			return *Traits;
+		}
+	}
+
+	// Build outside of the lock, as IsThreadSafe may run Blueprint script
+	const FSaveGameClassTraits Traits = BuildClassTraits(Class);
+
+	FWriteScopeLock WriteLock(GSaveGameClassTraitsLock);
+	return GSaveGameClassTraits.FindOrAdd(Class, Traits);
+}
+
+void FSaveGameClassTraits::Reset()
+{
+	FWriteScopeLock WriteLock(GSaveGameClassTraitsLock);
+	GSaveGameClassTraits.Reset();
+}
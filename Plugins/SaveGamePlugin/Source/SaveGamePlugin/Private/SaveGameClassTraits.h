@@ -0,0 +1,52 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Cached information about how a class participates in the save game.
+ *
+ * Reflection queries (i.e. Implements<>) and the IsThreadSafe event are resolved once per class, on first use,
+ * so that the per-actor hot paths only need a lookup. IsThreadSafe is evaluated against the class default object.
+ */
+struct FSaveGameClassTraits
+{
+	FSaveGameClassTraits()
+		: bIsSaveGameObject(false)
+		, bIsSpawnActor(false)
+		, bIsThreadSafe(false)
+		, bIsColumnar(false)
+		, bHasBulkArrays(false)
+	{}
+
+	/** Implements ISaveGameObject, and should be saved */
+	uint8 bIsSaveGameObject : 1;
+
+	/** Implements ISaveGameSpawnActor, and can be mapped by its SpawnID */
+	uint8 bIsSpawnActor : 1;
+
+	/** ISaveGameObject::IsThreadSafe returned true, OnSerialize can be called from a worker thread */
+	uint8 bIsThreadSafe : 1;
+
+	/** Is one of USaveGameSettings::ColumnarClasses, and all of its SaveGame properties can be stored as columns */
+	uint8 bIsColumnar : 1;
+
+	/** Has SaveGame arrays that are stored in bulk (see FSaveGameBulkArrays) */
+	uint8 bHasBulkArrays : 1;
+
+	/** The SaveGame arrays that are stored in bulk, only set if the class has any */
+	TSharedPtr<const TArray<const FProperty*>> BulkArrayProperties;
+
+	/** Returns the traits for this class, filling the cache if this class hasn't been seen before. Thread-safe. */
+	static FSaveGameClassTraits Get(const UClass* Class);
+
+	/** Returns the traits of an object's class, or default (empty) traits if the object is null */
+	static FSaveGameClassTraits Get(const UObject* Object)
+	{
+		return Object ? Get(Object->GetClass()) : FSaveGameClassTraits();
+	}
+
+	/** Clears the cache, i.e. when classes may have been recompiled */
+	static void Reset();
+};
@@ -0,0 +1,318 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameColumns.h"
+
+#include "SaveGameClassTraits.h"
+
+#include "UObject/EnumProperty.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSaveGameColumns, Log, All);
+
+namespace SaveGameColumns
+{
+	/** Packs a byte per row into a bit per row, eight rows at a time */
+	void PackBits(const TArray<uint8>& Bytes, TArray<uint8>& OutBits)
+	{
+		OutBits.SetNumUninitialized(FMath::DivideAndRoundUp(Bytes.Num(), 8));
+
+		for (int32 BitsIdx = 0; BitsIdx < OutBits.Num(); ++BitsIdx)
+		{
+			const int32 FirstRow = BitsIdx * 8;
+			const int32 NumRows = FMath::Min(8, Bytes.Num() - FirstRow);
+
+			uint8 Bits = 0;
+			for (int32 Bit = 0; Bit < NumRows; ++Bit)
+			{
+				Bits |= (Bytes[FirstRow + Bit] != 0) << Bit;
+			}
+
+			OutBits[BitsIdx] = Bits;
+		}
+	}
+
+	/** Unpacks a bit per row into a byte per row, eight rows at a time */
+	void UnpackBits(const TArray<uint8>& Bits, int32 NumRows, TArray<uint8>& OutBytes)
+	{
+		OutBytes.SetNumUninitialized(NumRows);
+
+		for (int32 BitsIdx = 0; BitsIdx < Bits.Num(); ++BitsIdx)
+		{
+			const int32 FirstRow = BitsIdx * 8;
+			const int32 NumBitRows = FMath::Min(8, NumRows - FirstRow);
+
+			for (int32 Bit = 0; Bit < NumBitRows; ++Bit)
+			{
+				OutBytes[FirstRow + Bit] = (Bits[BitsIdx] >> Bit) & 1;
+			}
+		}
+	}
+}
+
+bool FSaveGameColumns::CanStoreAsColumn(const FProperty* Property)
+{
+	if (Property->ArrayDim != 1)
+	{
+		return false;
+	}
+
+	if (Property->IsA<FBoolProperty>() || Property->IsA<FNumericProperty>() || Property->IsA<FEnumProperty>())
+	{
+		return true;
+	}
+
+	// Rows are copied with memcpy, so any padding would be saved as whatever happened to be in memory
+	const FStructProperty* StructProperty = CastField<FStructProperty>(Property);
+	return StructProperty && (StructProperty->Struct->StructFlags & STRUCT_IsPlainOldData) != 0 && !HasPadding(StructProperty->Struct);
+}
+
+bool FSaveGameColumns::HasPadding(const UScriptStruct* Struct)
+{
+	int32 PropertyBytes = 0;
+
+	for (TFieldIterator<FProperty> It(Struct); It; ++It)
+	{
+		const FStructProperty* StructProperty = CastField<FStructProperty>(*It);
+		if (StructProperty && HasPadding(StructProperty->Struct))
+		{
+			return true;
+		}
+
+		PropertyBytes += It->GetSize();
+	}
+
+	return PropertyBytes != Struct->GetStructureSize();
+}
+
+FName FSaveGameColumns::GetColumnType(const FProperty* Property)
+{
+	if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+	{
+		return StructProperty->Struct->GetFName();
+	}
+
+	return Property->GetClass()->GetFName();
+}
+
+int32 FSaveGameColumns::GetColumnElementSize(const FProperty* Property)
+{
+	return Property->IsA<FBoolProperty>() ? 0 : Property->GetSize();
+}
+
+void FSaveGameColumns::AssignRows(const TArray<TWeakObjectPtr<AActor>>& Actors, TArray<int32>& OutRows)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_AssignColumnRows);
+
+	check(IsInGameThread());
+
+	Classes.Reset();
+	ClassIndices.Reset();
+	OutRows.Init(INDEX_NONE, Actors.Num());
+
+	for (int32 ActorIdx = 0; ActorIdx < Actors.Num(); ++ActorIdx)
+	{
+		const AActor* Actor = Actors[ActorIdx].Get();
+
+		if (!Actor || !FSaveGameClassTraits::Get(Actor).bIsColumnar)
+		{
+			continue;
+		}
+
+		const UClass* Class = Actor->GetClass();
+		int32* ClassIdx = ClassIndices.Find(Class);
+
+		if (!ClassIdx)
+		{
+			ClassIdx = &ClassIndices.Add(Class, Classes.AddDefaulted());
+
+			FClassColumns& ClassColumns = Classes[*ClassIdx];
+			ClassColumns.ClassPath = Class;
+
+			// Columnar classes only have properties that can be stored as columns (see FSaveGameClassTraits)
+			for (TFieldIterator<FProperty> It(Class); It; ++It)
+			{
+				if (It->HasAnyPropertyFlags(CPF_SaveGame))
+				{
+					FColumn& Column = ClassColumns.Columns.AddDefaulted_GetRef();
+					Column.Name = It->GetFName();
+					Column.Type = GetColumnType(*It);
+					Column.ElementSize = GetColumnElementSize(*It);
+					Column.Property = *It;
+				}
+			}
+		}
+
+		OutRows[ActorIdx] = Classes[*ClassIdx].NumRows++;
+	}
+
+	// Now that we know how many rows there are, allocate the columns up front so that rows can be written from any thread
+	for (FClassColumns& ClassColumns : Classes)
+	{
+		for (FColumn& Column : ClassColumns.Columns)
+		{
+			Column.Data.SetNumZeroed(ClassColumns.NumRows * FMath::Max(Column.ElementSize, 1));
+		}
+	}
+}
+
+void FSaveGameColumns::ResolveProperties()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_ResolveColumns);
+
+	check(IsInGameThread());
+
+	ClassIndices.Reset();
+
+	for (int32 ClassIdx = 0; ClassIdx < Classes.Num(); ++ClassIdx)
+	{
+		FClassColumns& ClassColumns = Classes[ClassIdx];
+		const UClass* Class = ClassColumns.ClassPath.TryLoadClass<AActor>();
+
+		if (!Class)
+		{
+			continue;
+		}
+
+		ClassIndices.Add(Class, ClassIdx);
+
+		for (FColumn& Column : ClassColumns.Columns)
+		{
+			const FProperty* Property = FindFProperty<FProperty>(Class, Column.Name);
+
+			const bool bMatches = Property && CanStoreAsColumn(Property)
+				&& GetColumnType(Property) == Column.Type
+				&& GetColumnElementSize(Property) == Column.ElementSize
+				&& Column.Data.Num() == ClassColumns.NumRows * FMath::Max(Column.ElementSize, 1);
+
+			Column.Property = bMatches ? Property : nullptr;
+
+			UE_CLOG(!bMatches, LogSaveGameColumns, Warning, TEXT("Column %s of %s no longer matches its property, so won't be loaded"),
+				*Column.Name.ToString(), *ClassColumns.ClassPath.ToString());
+		}
+	}
+}
+
+int32 FSaveGameColumns::FindClass(const AActor* Actor, int32 Row) const
+{
+	const int32* ClassIdx = ClassIndices.Find(Actor->GetClass());
+
+	if (!ClassIdx || Row < 0 || Row >= Classes[*ClassIdx].NumRows)
+	{
+		return INDEX_NONE;
+	}
+
+	return *ClassIdx;
+}
+
+void FSaveGameColumns::WriteRow(const AActor* Actor, int32 Row)
+{
+	const int32 ClassIdx = FindClass(Actor, Row);
+
+	if (!ensure(ClassIdx != INDEX_NONE))
+	{
+		return;
+	}
+
+	for (FColumn& Column : Classes[ClassIdx].Columns)
+	{
+		const void* Value = Column.Property->ContainerPtrToValuePtr<void>(Actor);
+		uint8* RowData = Column.Data.GetData() + Row * FMath::Max(Column.ElementSize, 1);
+
+		if (Column.ElementSize == 0)
+		{
+			*RowData = CastFieldChecked<const FBoolProperty>(Column.Property)->GetPropertyValue(Value);
+		}
+		else
+		{
+			FMemory::Memcpy(RowData, Value, Column.ElementSize);
+		}
+	}
+}
+
+void FSaveGameColumns::ReadRow(AActor* Actor, int32 Row) const
+{
+	const int32 ClassIdx = FindClass(Actor, Row);
+
+	if (ClassIdx == INDEX_NONE)
+	{
+		return;
+	}
+
+	for (const FColumn& Column : Classes[ClassIdx].Columns)
+	{
+		if (!Column.Property)
+		{
+			continue;
+		}
+
+		void* Value = Column.Property->ContainerPtrToValuePtr<void>(Actor);
+		const uint8* RowData = Column.Data.GetData() + Row * FMath::Max(Column.ElementSize, 1);
+
+		if (Column.ElementSize == 0)
+		{
+			CastFieldChecked<const FBoolProperty>(Column.Property)->SetPropertyValue(Value, *RowData != 0);
+		}
+		else
+		{
+			FMemory::Memcpy(Value, RowData, Column.ElementSize);
+		}
+	}
+}
+
+void FSaveGameColumns::Serialize(FStructuredArchive::FSlot Slot)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_SerializeColumns);
+
+	const bool bIsLoading = Slot.GetUnderlyingArchive().IsLoading();
+
+	int32 NumClasses = Classes.Num();
+	FStructuredArchive::FArray ClassesArray = Slot.EnterArray(NumClasses);
+
+	if (bIsLoading)
+	{
+		Classes.SetNum(NumClasses);
+	}
+
+	for (FClassColumns& ClassColumns : Classes)
+	{
+		FStructuredArchive::FRecord ClassRecord = ClassesArray.EnterElement().EnterRecord();
+		ClassRecord << SA_VALUE(TEXT("Class"), ClassColumns.ClassPath);
+		ClassRecord << SA_VALUE(TEXT("NumRows"), ClassColumns.NumRows);
+
+		int32 NumColumns = ClassColumns.Columns.Num();
+		FStructuredArchive::FArray ColumnsArray = ClassRecord.EnterArray(TEXT("Columns"), NumColumns);
+
+		if (bIsLoading)
+		{
+			ClassColumns.Columns.SetNum(NumColumns);
+		}
+
+		for (FColumn& Column : ClassColumns.Columns)
+		{
+			FStructuredArchive::FRecord ColumnRecord = ColumnsArray.EnterElement().EnterRecord();
+			ColumnRecord << SA_VALUE(TEXT("Name"), Column.Name);
+			ColumnRecord << SA_VALUE(TEXT("Type"), Column.Type);
+			ColumnRecord << SA_VALUE(TEXT("ElementSize"), Column.ElementSize);
+
+			if (Column.ElementSize == 0)
+			{
+				TArray<uint8> Bits;
+
+				if (!bIsLoading)
+				{
+					SaveGameColumns::PackBits(Column.Data, Bits);
+				}
+
+				ColumnRecord << SA_VALUE(TEXT("Bits"), Bits);
+
+				if (bIsLoading)
+				{
+					SaveGameColumns::UnpackBits(Bits, FMath::Min(ClassColumns.NumRows, Bits.Num() * 8), Column.Data);
+				}
+			}
+			else
+			{
+				ColumnRecord << SA_VALUE(TEXT("Data"), Column.Data);
+			}
+		}
+	}
+}
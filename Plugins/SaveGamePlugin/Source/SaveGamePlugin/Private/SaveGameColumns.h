@@ -0,0 +1,87 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * The SaveGame properties of columnar classes (see USaveGameSettings::ColumnarClasses), stored as one contiguous
+ * column per property, rather than as tagged properties per actor.
+ *
+ * Each actor of a columnar class is given a row in its class's columns. Rows are written and read by whichever thread
+ * is serializing the actor, and as each actor only touches its own row, this doesn't need any locking. Bool columns
+ * are stored as a byte per row in memory, and are only bit-packed when the columns are serialized.
+ *
+ * Columns are matched to properties by name, type and size, so a column whose property has since been removed or
+ * changed is skipped when loading (leaving the property at its default).
+ */
+class FSaveGameColumns
+{
+public:
+	/** Only bools, numbers, enums and plain old data structs without padding can be copied to and from a column */
+	static bool CanStoreAsColumn(const FProperty* Property);
+
+	/**
+	 * Whether a struct has bytes that don't belong to any of its properties (i.e. padding), which aren't guaranteed to
+	 * be the same between saves. Packed bitfields are counted as padded too, as their properties overlap.
+	 */
+	static bool HasPadding(const UScriptStruct* Struct);
+
+	/** The property's type, or the struct's name if it's a struct, used to check that saved data still matches it */
+	static FName GetColumnType(const FProperty* Property);
+
+	/**
+	 * When saving, gives each actor of a columnar class a row in its class's columns, or INDEX_NONE if its class
+	 * isn't columnar. Must be called on the game thread.
+	 */
+	void AssignRows(const TArray<TWeakObjectPtr<AActor>>& Actors, TArray<int32>& OutRows);
+
+	/** When loading, finds the classes and properties of the columns that were read. Must be called on the game thread. */
+	void ResolveProperties();
+
+	/** Copies the actor's properties to its row */
+	void WriteRow(const AActor* Actor, int32 Row);
+
+	/** Copies the actor's row to its properties */
+	void ReadRow(AActor* Actor, int32 Row) const;
+
+	/** Whether there aren't any columnar actors, in which case actors don't store a row */
+	bool IsEmpty() const { return Classes.IsEmpty(); }
+
+	void Serialize(FStructuredArchive::FSlot Slot);
+
+private:
+	struct FColumn
+	{
+		FName Name;
+
+		/** The property's type, or the struct's name if it's a struct */
+		FName Type;
+
+		/** Zero for bools, as they are bit-packed when serialized */
+		int32 ElementSize = 0;
+
+		/** Null if the property no longer matches this column */
+		const FProperty* Property = nullptr;
+
+		/** Each row's value, one after the other */
+		TArray<uint8> Data;
+	};
+
+	struct FClassColumns
+	{
+		FSoftClassPath ClassPath;
+		int32 NumRows = 0;
+		TArray<FColumn> Columns;
+	};
+
+	static int32 GetColumnElementSize(const FProperty* Property);
+
+	/** Returns the index of the actor's class, or INDEX_NONE if it doesn't have columns or the row is out of range */
+	int32 FindClass(const AActor* Actor, int32 Row) const;
+
+	TArray<FClassColumns> Classes;
+
+	/** Which of the classes each class's actors are in, only changed on the game thread before serializing actors */
+	TMap<const UClass*, int32> ClassIndices;
+};
@@ -0,0 +1,154 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameCompressedChunks.h"
+
+#include "Async/ParallelFor.h"
+#include "Misc/Compression.h"
+
+#include <atomic>
+
+namespace SaveGameCompressedChunks
+{
+	/** Small enough that reading a field only decompresses a little more than it needs, large enough to compress well */
+	constexpr int32 ChunkSize = 128 * 1024;
+}
+
+void FSaveGameCompressedChunks::Write(FArchive& Ar, TConstArrayView<uint8> Data)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_CompressChunks);
+
+	check(!Ar.IsLoading());
+
+	int64 DataSize = Data.Num();
+	int32 DataChunkSize = SaveGameCompressedChunks::ChunkSize;
+	int32 NumChunks = FMath::DivideAndRoundUp<int64>(DataSize, DataChunkSize);
+
+	TArray<TArray<uint8>> Chunks;
+	Chunks.SetNum(NumChunks);
+
+	ParallelFor(NumChunks, [&](int32 ChunkIdx)
+	{
+		const int64 ChunkStart = static_cast<int64>(ChunkIdx) * DataChunkSize;
+		const int32 ChunkBytes = static_cast<int32>(FMath::Min<int64>(DataChunkSize, DataSize - ChunkStart));
+
+		TArray<uint8>& Chunk = Chunks[ChunkIdx];
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, ChunkBytes);
+		Chunk.SetNumUninitialized(CompressedSize);
+
+		verify(FCompression::CompressMemory(NAME_Zlib, Chunk.GetData(), CompressedSize, Data.GetData() + ChunkStart, ChunkBytes));
+		Chunk.SetNum(CompressedSize, EAllowShrinking::No);
+	});
+
+	Ar << DataSize;
+	Ar << DataChunkSize;
+	Ar << NumChunks;
+
+	for (TArray<uint8>& Chunk : Chunks)
+	{
+		int32 CompressedSize = Chunk.Num();
+		Ar << CompressedSize;
+	}
+
+	for (TArray<uint8>& Chunk : Chunks)
+	{
+		Ar.Serialize(Chunk.GetData(), Chunk.Num());
+	}
+}
+
+bool FSaveGameCompressedChunks::ReadTable(FArchive& Ar)
+{
+	check(Ar.IsLoading());
+
+	UncompressedSize = 0;
+	ChunkSize = 0;
+	CompressedOffsets.Reset();
+
+	int32 NumChunks = 0;
+	Ar << UncompressedSize;
+	Ar << ChunkSize;
+	Ar << NumChunks;
+
+	// Check the sizes before trusting them with any allocations. The data is decompressed into a TArray, and chunks
+	// are only ever written at our chunk size, so anything else can't have come from Write.
+	const bool bIsValidTable = !Ar.IsError() && UncompressedSize > 0 && UncompressedSize <= MAX_int32
+		&& ChunkSize == SaveGameCompressedChunks::ChunkSize
+		&& NumChunks == FMath::DivideAndRoundUp<int64>(UncompressedSize, ChunkSize)
+		&& static_cast<int64>(NumChunks) * sizeof(int32) <= Ar.TotalSize() - Ar.Tell();
+
+	if (!bIsValidTable)
+	{
+		return false;
+	}
+
+	CompressedOffsets.SetNumUninitialized(NumChunks + 1);
+	int64 ChunkOffset = Ar.Tell() + static_cast<int64>(NumChunks) * sizeof(int32);
+
+	for (int32 ChunkIdx = 0; ChunkIdx < NumChunks; ++ChunkIdx)
+	{
+		int32 CompressedSize = 0;
+		Ar << CompressedSize;
+
+		if (CompressedSize <= 0)
+		{
+			return false;
+		}
+
+		CompressedOffsets[ChunkIdx] = ChunkOffset;
+		ChunkOffset += CompressedSize;
+	}
+
+	CompressedOffsets[NumChunks] = ChunkOffset;
+
+	if (Ar.IsError() || ChunkOffset > Ar.TotalSize())
+	{
+		return false;
+	}
+
+	Ar.Seek(ChunkOffset);
+	return true;
+}
+
+void FSaveGameCompressedChunks::GetChunks(int64 Offset, int64 Size, int32& OutFirstChunk, int32& OutLastChunk) const
+{
+	OutFirstChunk = static_cast<int32>(Offset / ChunkSize);
+	OutLastChunk = static_cast<int32>((Offset + FMath::Max<int64>(Size, 1) - 1) / ChunkSize);
+}
+
+bool FSaveGameCompressedChunks::DecompressChunk(TConstArrayView<uint8> CompressedData, int32 ChunkIdx, TArrayView<uint8> OutData) const
+{
+	// The table was read from CompressedData, so its chunks should fit, but that's up to the caller
+	if (!IsValidIndex(ChunkIdx) || OutData.Num() != UncompressedSize || CompressedOffsets.Last() > CompressedData.Num())
+	{
+		return false;
+	}
+
+	const int64 ChunkStart = static_cast<int64>(ChunkIdx) * ChunkSize;
+	const int32 ChunkBytes = static_cast<int32>(FMath::Min<int64>(ChunkSize, UncompressedSize - ChunkStart));
+	const int64 CompressedStart = CompressedOffsets[ChunkIdx];
+	const int32 CompressedSize = static_cast<int32>(CompressedOffsets[ChunkIdx + 1] - CompressedStart);
+
+	return FCompression::UncompressMemory(NAME_Zlib, OutData.GetData() + ChunkStart, ChunkBytes, CompressedData.GetData() + CompressedStart, CompressedSize);
+}
+
+bool FSaveGameCompressedChunks::DecompressAll(TConstArrayView<uint8> CompressedData, TArray<uint8>& OutData) const
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_DecompressChunks);
+
+	OutData.SetNumUninitialized(UncompressedSize);
+
+	std::atomic<bool> bSuccess = true;
+	ParallelFor(Num(), [&](int32 ChunkIdx)
+	{
+		if (!DecompressChunk(CompressedData, ChunkIdx, OutData))
+		{
+			bSuccess = false;
+		}
+	});
+
+	if (!bSuccess)
+	{
+		OutData.Empty();
+	}
+
+	return bSuccess;
+}
@@ -0,0 +1,56 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Save game data compressed in independent chunks, so that a reader can decompress only the chunks that it reads
+ * (see FSaveGameFileView), while a full load decompresses every chunk in parallel.
+ *
+ * Layout:
+ * - Uncompressed Size
+ * - Chunk Size: The uncompressed size of every chunk, apart from the last
+ * - Compressed Sizes: One per chunk
+ * - Each chunk, compressed with Zlib
+ */
+class FSaveGameCompressedChunks
+{
+public:
+	/** Compresses the data's chunks in parallel, then writes them after the table */
+	static void Write(FArchive& Ar, TConstArrayView<uint8> Data);
+
+	/**
+	 * Reads the table, leaving the archive after the last chunk.
+	 * @return false if the table is invalid (i.e. wasn't written by Write), or its chunks don't fit in the archive
+	 */
+	bool ReadTable(FArchive& Ar);
+
+	int64 GetUncompressedSize() const { return UncompressedSize; }
+
+	/** The uncompressed size of every chunk, apart from the last */
+	int32 GetChunkSize() const { return ChunkSize; }
+
+	int32 Num() const { return FMath::Max(CompressedOffsets.Num() - 1, 0); }
+	bool IsValidIndex(int32 ChunkIdx) const { return ChunkIdx >= 0 && ChunkIdx < Num(); }
+
+	/** The chunks that hold this range of the uncompressed data, OutLastChunk is inclusive */
+	void GetChunks(int64 Offset, int64 Size, int32& OutFirstChunk, int32& OutLastChunk) const;
+
+	/**
+	 * Decompresses a chunk into its place in the uncompressed data. Different chunks can be decompressed at once.
+	 * @param CompressedData The data that the table was read from
+	 * @return false if the chunk couldn't be decompressed, or doesn't fit in either the compressed or the output data
+	 */
+	bool DecompressChunk(TConstArrayView<uint8> CompressedData, int32 ChunkIdx, TArrayView<uint8> OutData) const;
+
+	/** Decompresses every chunk in parallel, leaves OutData empty if any of them couldn't be */
+	bool DecompressAll(TConstArrayView<uint8> CompressedData, TArray<uint8>& OutData) const;
+
+private:
+	int64 UncompressedSize = 0;
+	int32 ChunkSize = 0;
+
+	/** Where each chunk starts in the compressed data, followed by where the last chunk ends */
+	TArray<int64> CompressedOffsets;
+};
@@ -0,0 +1,419 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameFileView.h"
+
+#include "SaveGameCompressedChunks.h"
+#include "SaveGameProxyArchive.h"
+#include "SaveGameSlotHeader.h"
+#include "SaveGameVersion.h"
+
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Formatters/BinaryArchiveFormatter.h"
+#include "PlatformFeatures.h"
+#include "SaveGameSystem.h"
+#include "Serialization/MemoryArchive.h"
+#include "Serialization/MemoryReader.h"
+
+struct FSaveGameFileView::FChunkedData
+{
+	FSaveGameCompressedChunks Chunks;
+	TArray<uint8> CompressedData;
+
+	/** Mutable, as chunks are decompressed by the view's (const) readers */
+	mutable FCriticalSection DecompressSection;
+	mutable TBitArray<> DecompressedChunks;
+};
+
+/** Reads the view's data like an FMemoryReader, decompressing the chunks that it reads as it goes */
+class FSaveGameFileView::FChunkReader final : public FMemoryArchive
+{
+public:
+	FChunkReader(const FSaveGameFileView& InView)
+		: View(InView)
+	{
+		this->SetIsLoading(true);
+		this->SetIsPersistent(true);
+	}
+
+	virtual FString GetArchiveName() const override { return TEXT("FSaveGameFileView::FChunkReader"); }
+
+	virtual int64 TotalSize() override { return View.Data.Num(); }
+
+	virtual void Serialize(void* OutData, int64 Num) override
+	{
+		if (Num <= 0 || IsError())
+		{
+			return;
+		}
+
+		// Most reads are small, and fall within the chunks that we've already fetched
+		const bool bIsFetched = Offset >= FetchedStart && Offset + Num <= FetchedEnd;
+
+		if (Offset + Num > TotalSize() || (!bIsFetched && !View.FetchData(Offset, Num, FetchedStart, FetchedEnd)))
+		{
+			SetError();
+			return;
+		}
+
+		FMemory::Memcpy(OutData, View.Data.GetData() + Offset, Num);
+		Offset += Num;
+	}
+
+private:
+	const FSaveGameFileView& View;
+	int64 FetchedStart = 0;
+	int64 FetchedEnd = 0;
+};
+
+/** Reads the view's data the same way that a loading TSaveGameSerializer does, but only ever in binary */
+class FSaveGameFileView::FReader
+{
+public:
+	FReader(const FSaveGameFileView& View)
+		: MemoryReader(View)
+		, ProxyArchive(MemoryReader, Redirects)
+		, Formatter(ProxyArchive)
+		, StructuredArchive(Formatter)
+	{
+		ApplyVersions(View);
+	}
+
+	/** Properties (i.e. vectors) are serialized differently depending on the versions they were saved with */
+	void ApplyVersions(const FSaveGameFileView& View)
+	{
+		for (FArchive* Archive : { static_cast<FArchive*>(&MemoryReader), static_cast<FArchive*>(&ProxyArchive) })
+		{
+			Archive->SetEngineVer(View.EngineVersion);
+			Archive->SetUEVer(View.PackageVersion);
+			Archive->SetCustomVersions(View.CustomVersions);
+		}
+	}
+
+	FArchive& GetArchive() { return ProxyArchive; }
+	FBinaryArchiveFormatter& GetFormatter() { return Formatter; }
+
+	/** Can only be opened once per reader */
+	FStructuredArchive::FSlot Open() { return StructuredArchive.Open(); }
+
+private:
+	TMap<FSoftObjectPath, FSoftObjectPath> Redirects;
+	FChunkReader MemoryReader;
+	TSaveGameProxyArchive<true> ProxyArchive;
+	FBinaryArchiveFormatter Formatter;
+	FStructuredArchive StructuredArchive;
+};
+
+bool FSaveGameFileView::Open(const FString& SlotName)
+{
+	ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+
+	TArray<uint8> FileData;
+	if (!SaveSystem || !SaveSystem->LoadGame(false, *SlotName, 0, FileData))
+	{
+		return false;
+	}
+
+	if (!Open(MoveTemp(FileData)))
+	{
+		return false;
+	}
+
+	SlotInfo.SlotName = SlotName;
+	return true;
+}
+
+bool FSaveGameFileView::Open(TArray<uint8>&& FileData)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_OpenFileView);
+
+	Data.Empty();
+	ChunkedData.Reset();
+	Actors.Empty();
+	SlotInfo = FSaveGameSlotInfo();
+
+	FMemoryReader FileReader(FileData);
+	ESaveGameCompression Compression;
+	FSaveGameSlotHeader::Read(FileReader, SlotInfo, &Compression);
+
+	if (Compression == ESaveGameCompression::Chunks)
+	{
+		ChunkedData = MakePimpl<FChunkedData>();
+
+		if (!ChunkedData->Chunks.ReadTable(FileReader))
+		{
+			ChunkedData.Reset();
+			return false;
+		}
+
+		// Keep the compressed data, and only decompress its chunks as they're read
+		ChunkedData->CompressedData = MoveTemp(FileData);
+		ChunkedData->DecompressedChunks.Init(false, ChunkedData->Chunks.Num());
+		Data.SetNumUninitialized(ChunkedData->Chunks.GetUncompressedSize());
+	}
+	else
+	{
+		int64 UncompressedSize = 0;
+		FileReader << UncompressedSize;
+
+		if (FileReader.IsError() || UncompressedSize <= 0)
+		{
+			return false;
+		}
+
+		// Saves from before chunks can only be decompressed as a whole
+		Data.SetNumUninitialized(UncompressedSize);
+		FileReader.SerializeCompressed(Data.GetData(), UncompressedSize, NAME_Zlib);
+
+		// We don't need the compressed data anymore
+		FileData.Empty();
+
+		if (FileReader.IsError())
+		{
+			Data.Empty();
+			return false;
+		}
+	}
+
+	if (!IndexActors())
+	{
+		Data.Empty();
+		ChunkedData.Reset();
+		Actors.Empty();
+		return false;
+	}
+
+	return true;
+}
+
+bool FSaveGameFileView::IndexActors()
+{
+	FReader Reader(*this);
+	FArchive& Archive = Reader.GetArchive();
+	FStructuredArchive::FRecord Record = Reader.Open().EnterRecord();
+
+	// Follows the order of TSaveGameSerializer's Prepare and SerializeActors
+	uint64 VersionOffset = 0;
+	Record << SA_VALUE(TEXT("VersionsOffset"), VersionOffset);
+	Record << SA_VALUE(TEXT("EngineVersion"), EngineVersion);
+	Record << SA_VALUE(TEXT("PackageVersion"), PackageVersion);
+	Record << SA_VALUE(TEXT("Map"), MapName);
+
+	if (VersionOffset >= static_cast<uint64>(Data.Num()))
+	{
+		return false;
+	}
+
+	const int64 HeaderEnd = Archive.Tell();
+	Archive.Seek(VersionOffset);
+	CustomVersions.Serialize(Record.EnterField(TEXT("Versions")));
+	Archive.Seek(HeaderEnd);
+
+	Reader.ApplyVersions(*this);
+
+	// We don't need these, but need to read past them
+	int32 NumDestroyedActors = 0;
+	FStructuredArchive::FArray DestroyedActorsArray = Record.EnterArray(TEXT("DestroyedActors"), NumDestroyedActors);
+
+	for (int32 DestroyedIdx = 0; DestroyedIdx < NumDestroyedActors; ++DestroyedIdx)
+	{
+		FName ActorName;
+		DestroyedActorsArray.EnterElement() << ActorName;
+	}
+
+	const FCustomVersion* SaveGameVersion = CustomVersions.GetVersion(FSaveGameVersion::GUID);
+	bHasDataOffsets = SaveGameVersion && SaveGameVersion->Version >= FSaveGameVersion::ActorDataOffsets;
+	const bool bHasActorIndex = SaveGameVersion && SaveGameVersion->Version >= FSaveGameVersion::ActorIndex;
+
+	uint64 ActorIndexOffset = 0;
+	if (bHasActorIndex)
+	{
+		Archive << ActorIndexOffset;
+	}
+
+	TArray<uint64> ActorOffsets;
+	Archive << ActorOffsets;
+
+	if (Archive.IsError())
+	{
+		return false;
+	}
+
+	Actors.Reserve(ActorOffsets.Num());
+
+	if (bHasActorIndex)
+	{
+		// Everything we need is in the index, so none of the actors need to be read (or decompressed)
+		TArray<FString> ActorNames;
+		TArray<FString> ActorClasses;
+
+		Archive.Seek(ActorIndexOffset);
+		Archive << ActorNames;
+		Archive << ActorClasses;
+
+		if (Archive.IsError() || ActorNames.Num() != ActorOffsets.Num() || ActorClasses.Num() != ActorOffsets.Num())
+		{
+			return false;
+		}
+
+		for (int32 ActorIdx = 0; ActorIdx < ActorOffsets.Num(); ++ActorIdx)
+		{
+			FActorEntry& Entry = Actors.AddDefaulted_GetRef();
+			Entry.Name = *ActorNames[ActorIdx];
+			Entry.Class = FSoftClassPath(ActorClasses[ActorIdx]);
+			Entry.Offset = ActorOffsets[ActorIdx];
+		}
+	}
+	else
+	{
+		// Only read the start of each actor, using the formatter directly as these are separate records
+		FBinaryArchiveFormatter& Formatter = Reader.GetFormatter();
+
+		for (const uint64 ActorOffset : ActorOffsets)
+		{
+			FActorEntry& Entry = Actors.AddDefaulted_GetRef();
+			Entry.Offset = ActorOffset;
+
+			Archive.Seek(ActorOffset);
+
+			if (bHasDataOffsets)
+			{
+				uint64 DataOffset = 0;
+				Archive << DataOffset;
+			}
+
+			FString ActorName;
+			Formatter.Serialize(ActorName);
+			Entry.Name = *ActorName;
+
+			if (Formatter.TryEnterField(SA_FIELD_NAME(TEXT("Class")), false))
+			{
+				Formatter.Serialize(Entry.Class);
+			}
+		}
+	}
+
+	// Fast comparison only compares name indices, which is fine as we only need a consistent order
+	Algo::SortBy(Actors, &FActorEntry::Name, FNameFastLess());
+
+	return !Archive.IsError();
+}
+
+bool FSaveGameFileView::FetchData(int64 Offset, int64 Size, int64& OutStart, int64& OutEnd) const
+{
+	if (!ChunkedData.IsValid())
+	{
+		// Older saves are decompressed as a whole when opened
+		OutStart = 0;
+		OutEnd = Data.Num();
+		return true;
+	}
+
+	const FSaveGameCompressedChunks& Chunks = ChunkedData->Chunks;
+
+	int32 FirstChunk, LastChunk;
+	Chunks.GetChunks(Offset, Size, FirstChunk, LastChunk);
+
+	OutStart = static_cast<int64>(FirstChunk) * Chunks.GetChunkSize();
+	OutEnd = FMath::Min(static_cast<int64>(LastChunk + 1) * Chunks.GetChunkSize(), Chunks.GetUncompressedSize());
+
+	// Chunks are only decompressed once, so this is only contended while a chunk is first being read
+	FScopeLock Lock(&ChunkedData->DecompressSection);
+
+	for (int32 ChunkIdx = FirstChunk; ChunkIdx <= LastChunk; ++ChunkIdx)
+	{
+		if (ChunkedData->DecompressedChunks[ChunkIdx])
+		{
+			continue;
+		}
+
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_FileViewDecompressChunk);
+
+		if (!Chunks.DecompressChunk(ChunkedData->CompressedData, ChunkIdx, Data))
+		{
+			return false;
+		}
+
+		ChunkedData->DecompressedChunks[ChunkIdx] = true;
+	}
+
+	return true;
+}
+
+int32 FSaveGameFileView::FindActor(FName ActorName) const
+{
+	return Algo::BinarySearchBy(Actors, ActorName, &FActorEntry::Name, FNameFastLess());
+}
+
+bool FSaveGameFileView::FindField(FReader& Reader, int32 ActorIdx, FName FieldName, uint64& OutFieldOffset) const
+{
+	if (!Actors.IsValidIndex(ActorIdx) || !bHasDataOffsets)
+	{
+		return false;
+	}
+
+	FArchive& Archive = Reader.GetArchive();
+
+	// Each actor starts with where its custom data starts
+	uint64 DataOffset = 0;
+	Archive.Seek(Actors[ActorIdx].Offset);
+	Archive << DataOffset;
+
+	if (DataOffset == 0 || Archive.IsError())
+	{
+		return false;
+	}
+
+	// Mirrors FSaveGameArchive, which starts with the offset to its field table
+	const uint64 StartPosition = Actors[ActorIdx].Offset + DataOffset;
+	Archive.Seek(StartPosition);
+
+	uint64 FieldsOffset = 0;
+	Archive << FieldsOffset;
+	Archive.Seek(StartPosition + FieldsOffset);
+
+	TMap<FName, uint64> Fields;
+	Archive << Fields;
+
+	const uint64* FieldOffset = Fields.Find(FieldName);
+	if (!FieldOffset || Archive.IsError())
+	{
+		return false;
+	}
+
+	OutFieldOffset = StartPosition + *FieldOffset;
+	return true;
+}
+
+bool FSaveGameFileView::HasField(int32 ActorIdx, FName FieldName) const
+{
+	FReader Reader(*this);
+	uint64 FieldOffset;
+	return FindField(Reader, ActorIdx, FieldName, FieldOffset);
+}
+
+bool FSaveGameFileView::ReadField(int32 ActorIdx, FName FieldName, TFunctionRef<void(FStructuredArchive::FSlot)> ReadFunction) const
+{
+	FReader Reader(*this);
+
+	uint64 FieldOffset;
+	if (!FindField(Reader, ActorIdx, FieldName, FieldOffset))
+	{
+		return false;
+	}
+
+	Reader.GetArchive().Seek(FieldOffset);
+	ReadFunction(Reader.Open());
+
+	return !Reader.GetArchive().IsError();
+}
+
+bool FSaveGameFileView::ReadField(int32 ActorIdx, FName FieldName, const FProperty* Property, void* OutValue) const
+{
+	check(Property && OutValue);
+
+	return ReadField(ActorIdx, FieldName, [Property, OutValue](FStructuredArchive::FSlot Slot)
+	{
+		Property->SerializeItem(Slot, OutValue, nullptr);
+	});
+}
@@ -0,0 +1,263 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameBenchmarkStats.h"
+#include "SaveGameProxyArchive.h"
+
+#include "Dom/JsonObject.h"
+#include "Formatters/BinaryArchiveFormatter.h"
+#include "Formatters/NullArchiveFormatter.h"
+#include "Misc/AutomationTest.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_TEXT_ARCHIVE_SUPPORT
+#include "Formatters/JsonOutputArchiveFormatter.h"
+#include "Formatters/SaveGameArchiveFormatter.h"
+#endif
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Measures the cost of each structured archive formatter in isolation, without a world or any actors.
+ *
+ * Writes synthetic records, arrays, maps, strings, names and object paths through each formatter (binary, the save
+ * game's binary and JSON proxy, null and JSON), the same way that TSaveGameSerializer does (through a
+ * TSaveGameProxyArchive). Each formatter and case is its own test, which reports the median nanoseconds, allocations
+ * and output bytes per value. Allocations are only counted when stats are enabled.
+ */
+namespace SaveGameFormatterBenchmark
+{
+	using namespace SaveGameBenchmarkStats;
+
+	constexpr int32 NumValues = 10000;
+
+	/** Recorded iterations, after one warm up */
+	constexpr int32 NumIterations = 10;
+
+	/** Generated up front, so that creating them isn't measured */
+	struct FValues
+	{
+		TArray<FString> Strings;
+		TArray<FName> Names;
+		TArray<FSoftObjectPath> ObjectPaths;
+	};
+
+	/** Writes a kind of value to the root record, returns the number of values written */
+	using FWriteFunction = int32(*)(FStructuredArchive::FRecord Root, FValues& Values, int32 NumValues);
+
+	struct FCase
+	{
+		const TCHAR* Name;
+		FWriteFunction Write;
+	};
+
+	struct FFormatter
+	{
+		const TCHAR* Name;
+		TUniquePtr<FStructuredArchiveFormatter>(*Create)(FArchive& Archive);
+
+		/** The size of what the formatter wrote, once its archive has been closed */
+		int64(*GetOutputSize)(FStructuredArchiveFormatter& Formatter, const TArray<uint8>& Buffer);
+	};
+
+	int32 WriteRecords(FStructuredArchive::FRecord Root, FValues& Values, int32 NumValues)
+	{
+		// Two fields per record, like a small struct
+		const int32 NumRecords = NumValues / 2;
+		FStructuredArchive::FStream Stream = Root.EnterStream(TEXT("Records"));
+
+		for (int32 RecordIdx = 0; RecordIdx < NumRecords; ++RecordIdx)
+		{
+			int32 IntValue = RecordIdx;
+			float FloatValue = static_cast<float>(RecordIdx);
+
+			FStructuredArchive::FRecord Record = Stream.EnterElement().EnterRecord();
+			Record << SA_VALUE(TEXT("Int"), IntValue);
+			Record << SA_VALUE(TEXT("Float"), FloatValue);
+		}
+
+		return NumRecords * 2;
+	}
+
+	int32 WriteArray(FStructuredArchive::FRecord Root, FValues& Values, int32 NumValues)
+	{
+		int32 NumElements = NumValues;
+		FStructuredArchive::FArray Array = Root.EnterArray(TEXT("Array"), NumElements);
+
+		for (int32 ValueIdx = 0; ValueIdx < NumValues; ++ValueIdx)
+		{
+			int32 Value = ValueIdx;
+			Array.EnterElement() << Value;
+		}
+
+		return NumValues;
+	}
+
+	int32 WriteMap(FStructuredArchive::FRecord Root, FValues& Values, int32 NumValues)
+	{
+		int32 NumElements = NumValues;
+		FStructuredArchive::FMap Map = Root.EnterMap(TEXT("Map"), NumElements);
+
+		for (int32 ValueIdx = 0; ValueIdx < NumValues; ++ValueIdx)
+		{
+			int32 Value = ValueIdx;
+			Map.EnterElement(Values.Strings[ValueIdx]) << Value;
+		}
+
+		return NumValues;
+	}
+
+	template<typename ValueType, TArray<ValueType> FValues::*ValuesMember>
+	int32 WriteValues(FStructuredArchive::FRecord Root, FValues& Values, int32 NumValues)
+	{
+		int32 NumElements = NumValues;
+		FStructuredArchive::FArray Array = Root.EnterArray(TEXT("Values"), NumElements);
+
+		for (ValueType& Value : Values.*ValuesMember)
+		{
+			Array.EnterElement() << Value;
+		}
+
+		return NumValues;
+	}
+
+	int64 GetBufferSize(FStructuredArchiveFormatter& Formatter, const TArray<uint8>& Buffer)
+	{
+		return Buffer.Num();
+	}
+
+#if WITH_TEXT_ARCHIVE_SUPPORT
+	/** The JSON formatter only builds a document, so measure the (condensed, UTF-8) text that it would be saved as */
+	int64 GetJsonSize(FStructuredArchiveFormatter& Formatter, const TArray<uint8>& Buffer)
+	{
+		FString JsonString;
+		FJsonSerializer::Serialize(static_cast<FJsonOutputArchiveFormatter&>(Formatter).GetRoot(),
+			TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&JsonString));
+
+		return FTCHARToUTF8(*JsonString).Length();
+	}
+#endif
+
+	const FCase Cases[] =
+	{
+		{ TEXT("Records"), &WriteRecords },
+		{ TEXT("Arrays"), &WriteArray },
+		{ TEXT("Maps"), &WriteMap },
+		{ TEXT("Strings"), &WriteValues<FString, &FValues::Strings> },
+		{ TEXT("Names"), &WriteValues<FName, &FValues::Names> },
+		{ TEXT("ObjectPaths"), &WriteValues<FSoftObjectPath, &FValues::ObjectPaths> },
+	};
+
+	const FFormatter Formatters[] =
+	{
+		{ TEXT("Binary"), [](FArchive& Archive) -> TUniquePtr<FStructuredArchiveFormatter> { return MakeUnique<FBinaryArchiveFormatter>(Archive); }, &GetBufferSize },
+#if WITH_TEXT_ARCHIVE_SUPPORT
+		// Only the binary half is measured for size, the JSON half is written to its own file
+		{ TEXT("SaveGame"), [](FArchive& Archive) -> TUniquePtr<FStructuredArchiveFormatter> { return MakeUnique<FSaveGameArchiveFormatter>(Archive, false); }, &GetBufferSize },
+#endif
+		{ TEXT("Null"), [](FArchive& Archive) -> TUniquePtr<FStructuredArchiveFormatter> { return MakeUnique<FNullArchiveFormatter>(); }, &GetBufferSize },
+#if WITH_TEXT_ARCHIVE_SUPPORT
+		{ TEXT("Json"), [](FArchive& Archive) -> TUniquePtr<FStructuredArchiveFormatter> { return MakeUnique<FJsonOutputArchiveFormatter>(); }, &GetJsonSize },
+#endif
+	};
+
+	void MakeValues(FValues& Values)
+	{
+		Values.Strings.Reserve(NumValues);
+		Values.Names.Reserve(NumValues);
+		Values.ObjectPaths.Reserve(NumValues);
+
+		for (int32 ValueIdx = 0; ValueIdx < NumValues; ++ValueIdx)
+		{
+			Values.Strings.Add(FString::Printf(TEXT("Value_%d"), ValueIdx));
+
+			// Names and paths are mostly made up of a handful of distinct strings, as they are in a level
+			Values.Names.Add(FName(TEXT("BenchmarkName"), ValueIdx % 64));
+			Values.ObjectPaths.Add(FSoftObjectPath(FString::Printf(TEXT("/Game/Maps/Benchmark.Benchmark:PersistentLevel.Actor_%d"), ValueIdx)));
+		}
+	}
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FSaveGameFormatterBenchmarkTest, "SaveGamePlugin.Benchmark.Formatter",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+void FSaveGameFormatterBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	using namespace SaveGameFormatterBenchmark;
+
+	for (int32 FormatterIdx = 0; FormatterIdx < UE_ARRAY_COUNT(Formatters); ++FormatterIdx)
+	{
+		for (int32 CaseIdx = 0; CaseIdx < UE_ARRAY_COUNT(Cases); ++CaseIdx)
+		{
+			OutBeautifiedNames.Add(FString::Printf(TEXT("%s.%s"), Formatters[FormatterIdx].Name, Cases[CaseIdx].Name));
+			OutTestCommands.Add(FString::Printf(TEXT("%d %d"), FormatterIdx, CaseIdx));
+		}
+	}
+}
+
+bool FSaveGameFormatterBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace SaveGameFormatterBenchmark;
+
+	FString FormatterString, CaseString;
+	verify(Parameters.Split(TEXT(" "), &FormatterString, &CaseString));
+
+	const FFormatter& Formatter = Formatters[FCString::Atoi(*FormatterString)];
+	const FCase& Case = Cases[FCString::Atoi(*CaseString)];
+
+	FValues Values;
+	MakeValues(Values);
+
+	// Reused between iterations, so that after the warm up, growing the buffer isn't measured
+	TArray<uint8> Buffer;
+	TMap<FSoftObjectPath, FSoftObjectPath> Redirects;
+
+	const double NanosecondsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1e9;
+
+	TArray<double> NanosecondsPerValue;
+	TArray<double> AllocationsPerValue;
+	double BytesPerValue = 0.0;
+
+	// The first iteration is a warm up, so isn't recorded
+	for (int32 Iteration = 0; Iteration <= NumIterations; ++Iteration)
+	{
+		Buffer.Reset();
+		FMemoryWriter Writer(Buffer);
+		TSaveGameProxyArchive<false> ProxyArchive(Writer, Redirects);
+		TUniquePtr<FStructuredArchiveFormatter> ArchiveFormatter = Formatter.Create(ProxyArchive);
+
+		const uint64 StartAllocations = GetNumAllocations();
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+
+		int32 NumWritten;
+		{
+			// Closing the archive is part of the cost (i.e. the JSON formatter finishing its objects)
+			FStructuredArchive StructuredArchive(*ArchiveFormatter);
+			NumWritten = Case.Write(StructuredArchive.Open().EnterRecord(), Values, NumValues);
+		}
+
+		const uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+		const uint64 Allocations = GetNumAllocations() - StartAllocations;
+
+		if (!TestTrue(TEXT("Values written"), NumWritten > 0))
+		{
+			return false;
+		}
+
+		if (Iteration > 0)
+		{
+			NanosecondsPerValue.Add(Cycles * NanosecondsPerCycle / NumWritten);
+			AllocationsPerValue.Add(static_cast<double>(Allocations) / NumWritten);
+			BytesPerValue = static_cast<double>(Formatter.GetOutputSize(*ArchiveFormatter, Buffer)) / NumWritten;
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("%s %s: %.1f ns, %s allocations, %.2f bytes per value"), Formatter.Name, Case.Name,
+		GetMedian(NanosecondsPerValue),
+		bCountsAllocations ? *FString::Printf(TEXT("%.2f"), GetMedian(AllocationsPerValue)) : TEXT("(uncounted)"),
+		BytesPerValue));
+
+	return true;
+}
+
+#endif
@@ -2,8 +2,11 @@
 
 #include "SaveGameFunctionLibrary.h"
 
+#include "SaveGameQuantizedTransform.h"
 #include "SaveGameSettings.h"
 #include "SaveGameThreading.h"
+#include "SaveGameTransformBatch.h"
+#include "Engine/World.h"
 
 #if WITH_EDITOR
 #include "Blueprint/BlueprintExceptionInfo.h"
@@ -63,42 +66,81 @@ bool USaveGameFunctionLibrary::SerializeActorTransform(FSaveGameArchive& Archive
 		const bool bIsLoading = Archive.GetRecord().GetUnderlyingArchive().IsLoading();
 
 		// Save into a slot only if the actor is movable
-		return (bIsLoading || bIsMovable) && Archive.SerializeField(TEXT("ActorTransform"), [&](FStructuredArchive::FSlot Slot)
+		if (!bIsLoading && !bIsMovable)
 		{
-			FTransform ActorTransform;
+			return false;
+		}
 
-			if (!bIsLoading)
-			{
-				ActorTransform = Actor->GetActorTransform();
-			}
+		const USaveGameSettings* Settings = GetDefault<USaveGameSettings>();
 
-			// Serialize the transform
-			Slot << ActorTransform;
+		// Quantized locations are relative to the level's origin, which moves with origin rebasing
+		const UWorld* World = Actor->GetWorld();
+		const FVector LevelOrigin = World ? -FVector(World->OriginLocation) : FVector::ZeroVector;
 
-			if (bIsLoading && bIsMovable)
-			{
-				auto SetActorTransform = [Actor = TWeakObjectPtr<AActor>(Actor), ActorTransform]
-				{
-					QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_SetActorTransform);
+		FTransform ActorTransform;
+		FSaveGameQuantizedTransform QuantizedTransform;
+
+		// Fall back to the full transform if the actor is too far from the origin to be quantized
+		const bool bQuantize = !bIsLoading && Settings->bQuantizeTransforms
+			&& QuantizedTransform.Encode(Actor->GetActorTransform(), LevelOrigin, Settings->TransformPrecision);
+
+		bool bSerialized = false;
 
-					// If the actor is movable, set its transform
-					if (Actor.IsValid())
-					{
-						Actor->SetActorTransform(ActorTransform, false, nullptr, ETeleportType::TeleportPhysics);
-					}
-				};
+		if (bIsLoading || bQuantize)
+		{
+			bSerialized = Archive.SerializeField(TEXT("QuantizedTransform"), [&](FStructuredArchive::FSlot Slot)
+			{
+				QuantizedTransform.Serialize(Slot);
+				ActorTransform = QuantizedTransform.Decode(LevelOrigin);
+			});
+		}
 
-				if (IsInGameThread())
+		if (!bSerialized && (bIsLoading || !bQuantize))
+		{
+			bSerialized = Archive.SerializeField(TEXT("ActorTransform"), [&](FStructuredArchive::FSlot Slot)
+			{
+				if (!bIsLoading)
 				{
-					// We're already in the game thread, execute immediately
-					SetActorTransform();
+					ActorTransform = Actor->GetActorTransform();
 				}
-				else
+
+				// Serialize the transform
+				Slot << ActorTransform;
+			});
+		}
+
+		if (bSerialized && bIsLoading && bIsMovable && Archive.GetTransformBatch() && Archive.GetTransformBatchIdx() != INDEX_NONE)
+		{
+			// Applied on the game thread with the rest of the load's transforms, once every actor has been serialized
+			Archive.GetTransformBatch()->Set(Archive.GetTransformBatchIdx(), Actor, ActorTransform);
+		}
+		else if (bSerialized && bIsLoading && bIsMovable)
+		{
+			auto SetActorTransform = [Actor = TWeakObjectPtr<AActor>(Actor), ActorTransform]
+			{
+				QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_SetActorTransform);
+
+				// If the actor is movable, set its transform
+				if (Actor.IsValid())
 				{
-					ISaveGameThreadQueue::Get().AddTask(Forward<ISaveGameThreadQueue::FTaskFunction>(SetActorTransform));
+					Actor->SetActorTransform(ActorTransform, false, nullptr, ETeleportType::TeleportPhysics);
 				}
+			};
+
+			if (IsInGameThread())
+			{
+				// We're already in the game thread, execute immediately
+				SetActorTransform();
 			}
-		});
+			else
+			{
+				// Prefer the archive's queue, otherwise fall back to the queue this thread is working for
+				ISaveGameThreadQueue* ThreadQueue = Archive.GetThreadQueue();
+				(ThreadQueue ? *ThreadQueue : ISaveGameThreadQueue::Get()).AddTask(MoveTemp(SetActorTransform));
+			}
+		}
+
+		return bSerialized;
 	}
 
 	return false;
@@ -221,7 +263,8 @@ DEFINE_FUNCTION(USaveGameFunctionLibrary::execCallOnGameThread)
 	}
 	else
 	{
-		ISaveGameThreadQueue::Get().AddTask(Forward<ISaveGameThreadQueue::FTaskFunction>(ProcessDelegate));
+		// Blueprint doesn't give us an archive here, so use the queue of the operation that this worker is running for
+		ISaveGameThreadQueue::Get().AddTask(MoveTemp(ProcessDelegate));
 	}
 
 	P_NATIVE_END;
@@ -0,0 +1,55 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameLevelActorIndex.h"
+
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+
+void FSaveGameLevelActorIndex::Build(const ULevel* Level)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_BuildLevelActorIndex);
+
+	check(IsInGameThread());
+	check(Level);
+
+	Entries.Reset(Level->Actors.Num());
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (IsValid(Actor))
+		{
+			Entries.Add({ Actor->GetFName(), Actor });
+		}
+	}
+
+	// Fast comparison only compares name indices, which is fine as we only need a consistent order
+	Algo::SortBy(Entries, &FEntry::Name, FNameFastLess());
+}
+
+void FSaveGameLevelActorIndex::Reset()
+{
+	Entries.Reset();
+}
+
+AActor* FSaveGameLevelActorIndex::Find(FName ActorName) const
+{
+	if (ActorName.IsNone())
+	{
+		return nullptr;
+	}
+
+	const int32 EntryIdx = Algo::BinarySearchBy(Entries, ActorName, &FEntry::Name, FNameFastLess());
+
+	if (EntryIdx != INDEX_NONE)
+	{
+		// Resolves to nullptr if the actor has since been destroyed or collected
+		return Entries[EntryIdx].Actor.Get();
+	}
+
+	return nullptr;
+}
+
+AActor* FSaveGameLevelActorIndex::Find(const FString& ActorName) const
+{
+	return Find(FName(*ActorName, FNAME_Find));
+}
@@ -0,0 +1,40 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+/**
+ * An immutable lookup of a level's actors by name.
+ *
+ * Built once on the game thread after a level is loaded, after which it can be read from any thread. This lets
+ * worker threads resolve level actors without needing to queue a FindObjectFast on the game thread. Actors are held
+ * weakly, as they can be destroyed (and garbage collected) between building the index and reading it.
+ */
+class FSaveGameLevelActorIndex
+{
+public:
+	/** Rebuilds the index from the level's current actors. Must be called on the game thread. */
+	void Build(const ULevel* Level);
+
+	void Reset();
+
+	/** Finds a live actor by name, returns nullptr if it's not in the index or has since been destroyed */
+	AActor* Find(FName ActorName) const;
+
+	/** Finds a live actor by name, without adding the name to the name table if it doesn't already exist */
+	AActor* Find(const FString& ActorName) const;
+
+	int32 Num() const { return Entries.Num(); }
+
+private:
+	struct FEntry
+	{
+		FName Name;
+		TWeakObjectPtr<AActor> Actor;
+	};
+
+	/** Sorted by name, for binary searching */
+	TArray<FEntry> Entries;
+};
@@ -2,9 +2,13 @@
 
 #include "SaveGameObject.h"
 
-FSaveGameArchive::FSaveGameArchive(FStructuredArchive::FRecord& InRecord, UObject* InObject)
+FSaveGameArchive::FSaveGameArchive(FStructuredArchive::FRecord& InRecord, UObject* InObject, ISaveGameThreadQueue* InThreadQueue,
+	FSaveGameTransformBatch* InTransformBatch, int32 InTransformBatchIdx)
 	: Record(&InRecord)
 	, Object(InObject)
+	, ThreadQueue(InThreadQueue)
+	, TransformBatch(InTransformBatch)
+	, TransformBatchIdx(InTransformBatchIdx)
 	, StartPosition(0)
 	, EndPosition(0)
 {
@@ -0,0 +1,83 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameOperation.h"
+
+#include "SaveGameSerializer.h"
+#include "SaveGameSubsystem.h"
+#include "SaveGameThreading.h"
+
+#include "Async/Async.h"
+
+bool USaveGameOperation::IsDone() const
+{
+	const ESaveGamePhase CurrentPhase = GetPhase();
+	return CurrentPhase == ESaveGamePhase::Complete || CurrentPhase == ESaveGamePhase::Cancelled;
+}
+
+FSaveGameProgress USaveGameOperation::GetProgress() const
+{
+	FSaveGameProgress Progress;
+	Progress.Phase = GetPhase();
+	Progress.CompletedActors = CompletedActors.load(std::memory_order_relaxed);
+	Progress.TotalActors = TotalActors.load(std::memory_order_relaxed);
+	return Progress;
+}
+
+void USaveGameOperation::Cancel()
+{
+	if (TSharedPtr<FSaveGameSerializer> PinnedSerializer = Serializer.Pin(); PinnedSerializer && !bIsLoading)
+	{
+		PinnedSerializer->Cancel();
+	}
+}
+
+void USaveGameOperation::Initialize(const TSharedRef<FSaveGameSerializer>& InSerializer, bool bInIsLoading)
+{
+	Serializer = InSerializer;
+	bIsLoading = bInIsLoading;
+}
+
+void USaveGameOperation::SetPhase(ESaveGamePhase NewPhase, int32 InTotalActors)
+{
+	CompletedActors.store(0, std::memory_order_relaxed);
+	TotalActors.store(InTotalActors, std::memory_order_relaxed);
+	Phase.store(NewPhase, std::memory_order_relaxed);
+
+	auto BroadcastPhaseChanged = [WeakThis = TWeakObjectPtr<USaveGameOperation>(this), NewPhase]
+	{
+		if (USaveGameOperation* This = WeakThis.Get())
+		{
+			This->OnPhaseChanged.Broadcast(This, NewPhase);
+		}
+	};
+
+	// While the game thread is pumping an operation's queue, it won't get back to the task graph until the actors are done
+	if (ISaveGameThreadQueue* ThreadQueue = ISaveGameThreadQueue::TryGet())
+	{
+		ThreadQueue->AddTask(MoveTemp(BroadcastPhaseChanged));
+	}
+	else
+	{
+		AsyncTask(ENamedThreads::GameThread, MoveTemp(BroadcastPhaseChanged));
+	}
+}
+
+void USaveGameOperation::Finish(bool bSuccess)
+{
+	SetPhase(bSuccess ? ESaveGamePhase::Complete : ESaveGamePhase::Cancelled);
+	CompletedEvent.Trigger();
+
+	AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<USaveGameOperation>(this), bSuccess]
+	{
+		if (USaveGameOperation* This = WeakThis.Get())
+		{
+			This->OnCompleted.Broadcast(This, bSuccess);
+
+			// We're no longer in flight, so the subsystem doesn't need to keep us alive anymore
+			if (USaveGameSubsystem* Subsystem = This->GetTypedOuter<USaveGameSubsystem>())
+			{
+				Subsystem->ActiveOperations.Remove(This);
+			}
+		}
+	});
+}
@@ -0,0 +1,129 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGamePhysicsStates.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Actor.h"
+
+void FSaveGamePhysicsStates::Capture(const TArray<TWeakObjectPtr<AActor>>& Actors)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_CapturePhysicsStates);
+
+	check(IsInGameThread());
+
+	States.Reset();
+
+	TInlineComponentArray<UPrimitiveComponent*> Primitives;
+
+	for (int32 ActorIdx = 0; ActorIdx < Actors.Num(); ++ActorIdx)
+	{
+		const AActor* Actor = Actors[ActorIdx].Get();
+
+		if (!Actor)
+		{
+			continue;
+		}
+
+		Actor->GetComponents(Primitives);
+
+		for (UPrimitiveComponent* Primitive : Primitives)
+		{
+			if (!Primitive->IsSimulatingPhysics())
+			{
+				continue;
+			}
+
+			FState& State = States.AddDefaulted_GetRef();
+			State.ActorIdx = ActorIdx;
+			State.ComponentName = Primitive == Actor->GetRootComponent() ? NAME_None : Primitive->GetFName();
+			State.bIsAwake = Primitive->RigidBodyIsAwake();
+
+			if (State.bIsAwake)
+			{
+				State.LinearVelocity = FVector3f(Primitive->GetPhysicsLinearVelocity());
+				State.AngularVelocity = FVector3f(Primitive->GetPhysicsAngularVelocityInDegrees());
+			}
+		}
+	}
+}
+
+void FSaveGamePhysicsStates::Restore(const TArray<TWeakObjectPtr<AActor>>& Actors)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_RestorePhysicsStates);
+
+	check(IsInGameThread());
+
+	TInlineComponentArray<UPrimitiveComponent*> Primitives;
+
+	for (const FState& State : States)
+	{
+		AActor* Actor = Actors.IsValidIndex(State.ActorIdx) ? Actors[State.ActorIdx].Get() : nullptr;
+
+		if (!Actor)
+		{
+			continue;
+		}
+
+		UPrimitiveComponent* Primitive = nullptr;
+
+		if (State.ComponentName.IsNone())
+		{
+			Primitive = Cast<UPrimitiveComponent>(Actor->GetRootComponent());
+		}
+		else
+		{
+			Actor->GetComponents(Primitives);
+
+			UPrimitiveComponent* const* FoundPrimitive = Primitives.FindByPredicate([&State](const UPrimitiveComponent* Component)
+			{
+				return Component->GetFName() == State.ComponentName;
+			});
+
+			Primitive = FoundPrimitive ? *FoundPrimitive : nullptr;
+		}
+
+		if (!Primitive || !Primitive->IsSimulatingPhysics())
+		{
+			continue;
+		}
+
+		if (State.bIsAwake)
+		{
+			Primitive->SetPhysicsLinearVelocity(FVector(State.LinearVelocity));
+			Primitive->SetPhysicsAngularVelocityInDegrees(FVector(State.AngularVelocity));
+		}
+		else
+		{
+			Primitive->PutRigidBodyToSleep();
+		}
+	}
+
+	States.Empty();
+}
+
+void FSaveGamePhysicsStates::Serialize(FStructuredArchive::FSlot Slot)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_SerializePhysicsStates);
+
+	int32 NumStates = States.Num();
+	FStructuredArchive::FArray StatesArray = Slot.EnterArray(NumStates);
+
+	if (Slot.GetUnderlyingArchive().IsLoading())
+	{
+		States.SetNum(NumStates);
+	}
+
+	for (FState& State : States)
+	{
+		FStructuredArchive::FRecord StateRecord = StatesArray.EnterElement().EnterRecord();
+		StateRecord << SA_VALUE(TEXT("Actor"), State.ActorIdx);
+		StateRecord << SA_VALUE(TEXT("Component"), State.ComponentName);
+		StateRecord << SA_VALUE(TEXT("Awake"), State.bIsAwake);
+
+		if (State.bIsAwake)
+		{
+			StateRecord << SA_VALUE(TEXT("LinearVelocity"), State.LinearVelocity);
+			StateRecord << SA_VALUE(TEXT("AngularVelocity"), State.AngularVelocity);
+		}
+	}
+}
@@ -0,0 +1,43 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * The velocities and sleep state of the simulating primitive components of saved actors (see
+ * USaveGameSettings::bSavePhysicsStates), captured and restored in one pass on the game thread rather than per actor.
+ *
+ * Only a component's root body is stored (i.e. not each bone of a ragdoll). Sleeping bodies don't store their
+ * velocities, as they don't have any.
+ */
+class FSaveGamePhysicsStates
+{
+public:
+	/** When saving, gathers the state of each actor's simulating primitives. Must be called on the game thread. */
+	void Capture(const TArray<TWeakObjectPtr<AActor>>& Actors);
+
+	/**
+	 * When loading, applies the states to the actors (in the same order as they were captured), then empties them.
+	 * Should be called after the actors' transforms have been set, as teleporting may change their velocities.
+	 * Must be called on the game thread.
+	 */
+	void Restore(const TArray<TWeakObjectPtr<AActor>>& Actors);
+
+	void Serialize(FStructuredArchive::FSlot Slot);
+
+private:
+	struct FState
+	{
+		int32 ActorIdx = INDEX_NONE;
+
+		/** None if it's the actor's root component */
+		FName ComponentName;
+
+		FVector3f LinearVelocity = FVector3f::ZeroVector;
+		FVector3f AngularVelocity = FVector3f::ZeroVector;
+		bool bIsAwake = false;
+	};
+
+	TArray<FState> States;
+};
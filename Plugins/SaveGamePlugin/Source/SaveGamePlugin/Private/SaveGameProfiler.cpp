@@ -0,0 +1,138 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameProfiler.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSaveGameProfiler, Log, All);
+
+static TAutoConsoleVariable<bool> CVarSaveGameProfile(
+	TEXT("SaveGame.Profile"),
+	false,
+	TEXT("If true, measures each actor class's time and size during save and load, and writes a report after each."));
+
+static FAutoConsoleCommandWithOutputDevice DumpSaveGameProfileCommand(
+	TEXT("SaveGame.DumpProfile"),
+	TEXT("Logs the last per-class report written while SaveGame.Profile was enabled."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&FSaveGameProfiler::DumpLastReport));
+
+namespace SaveGameProfiler
+{
+	struct FClassProfile
+	{
+		const UClass* Class = nullptr;
+		int32 NumActors = 0;
+		FSaveGameActorProfile Total;
+
+		uint64 GetTotalCycles() const
+		{
+			return Total.PropertiesCycles + Total.OnSerializeCycles;
+		}
+	};
+
+	/** Only accessed on the game thread */
+	FString LastReport;
+}
+
+bool FSaveGameProfiler::IsEnabled()
+{
+	return CVarSaveGameProfile.GetValueOnAnyThread();
+}
+
+void FSaveGameProfiler::Begin(int32 NumActors)
+{
+	Actors.Reset();
+
+	if (IsEnabled())
+	{
+		Actors.SetNum(NumActors);
+	}
+}
+
+void FSaveGameProfiler::Finish(bool bIsLoading, TFunctionRef<const UClass*(int32)> GetActorClass)
+{
+	using namespace SaveGameProfiler;
+
+	check(IsInGameThread());
+
+	if (Actors.IsEmpty())
+	{
+		return;
+	}
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_ProfilerReport);
+
+	TMap<const UClass*, FClassProfile> ClassProfiles;
+
+	for (int32 ActorIdx = 0; ActorIdx < Actors.Num(); ++ActorIdx)
+	{
+		const UClass* Class = GetActorClass(ActorIdx);
+		const FSaveGameActorProfile& ActorProfile = Actors[ActorIdx];
+
+		FClassProfile& ClassProfile = ClassProfiles.FindOrAdd(Class);
+		ClassProfile.Class = Class;
+		ClassProfile.NumActors++;
+		ClassProfile.Total.PropertiesCycles += ActorProfile.PropertiesCycles;
+		ClassProfile.Total.OnSerializeCycles += ActorProfile.OnSerializeCycles;
+		ClassProfile.Total.Bytes += ActorProfile.Bytes;
+		ClassProfile.Total.NumGameThreadTasks += ActorProfile.NumGameThreadTasks;
+	}
+
+	TArray<FClassProfile> SortedProfiles;
+	ClassProfiles.GenerateValueArray(SortedProfiles);
+
+	// The classes that cost the most go first
+	SortedProfiles.Sort([](const FClassProfile& A, const FClassProfile& B)
+	{
+		return A.GetTotalCycles() != B.GetTotalCycles() ? A.GetTotalCycles() > B.GetTotalCycles() : A.Total.Bytes > B.Total.Bytes;
+	});
+
+	const double MillisecondsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1000.0;
+
+	TStringBuilder<4096> Report;
+	Report << TEXT("Class,Actors,Bytes,PropertiesMs,OnSerializeMs,GameThreadTasks\n");
+
+	for (const FClassProfile& ClassProfile : SortedProfiles)
+	{
+		Report.Appendf(TEXT("%s,%d,%llu,%.3f,%.3f,%d\n"),
+			ClassProfile.Class ? *ClassProfile.Class->GetPathName() : TEXT("None"),
+			ClassProfile.NumActors,
+			ClassProfile.Total.Bytes,
+			ClassProfile.Total.PropertiesCycles * MillisecondsPerCycle,
+			ClassProfile.Total.OnSerializeCycles * MillisecondsPerCycle,
+			ClassProfile.Total.NumGameThreadTasks);
+	}
+
+	LastReport = Report.ToString();
+
+	const FString ReportPath = FPaths::ProfilingDir() / TEXT("SaveGame") /
+		FString::Printf(TEXT("%s_%s.csv"), bIsLoading ? TEXT("Load") : TEXT("Save"), *FDateTime::Now().ToString());
+
+	if (FFileHelper::SaveStringToFile(LastReport, *ReportPath))
+	{
+		UE_LOG(LogSaveGameProfiler, Log, TEXT("Wrote %s profile of %d actors to %s"), bIsLoading ? TEXT("load") : TEXT("save"), Actors.Num(), *ReportPath);
+	}
+
+	Actors.Empty();
+}
+
+void FSaveGameProfiler::DumpLastReport(FOutputDevice& Ar)
+{
+	using namespace SaveGameProfiler;
+
+	if (LastReport.IsEmpty())
+	{
+		Ar.Log(TEXT("No save game profile has been recorded, enable it with SaveGame.Profile 1"));
+		return;
+	}
+
+	TArray<FString> Lines;
+	LastReport.ParseIntoArrayLines(Lines);
+
+	for (const FString& Line : Lines)
+	{
+		Ar.Log(Line);
+	}
+}
@@ -0,0 +1,75 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** What we've measured for a single actor, each actor is only written to by whichever thread is processing it */
+struct FSaveGameActorProfile
+{
+	uint64 PropertiesCycles = 0;
+	uint64 OnSerializeCycles = 0;
+
+	/** How much of the archive this actor used, the same as FActorInfo::Data.Num() when saving */
+	uint64 Bytes = 0;
+
+	/** How many times this actor's work had to be queued to the game thread */
+	int32 NumGameThreadTasks = 0;
+};
+
+/**
+ * An optional per-class profiler for save and load (enable with SaveGame.Profile 1).
+ *
+ * Each actor's measurements are accumulated into its own slot, without any locking, then grouped by class once the
+ * actors have been serialized. The report is written as a CSV to the profiling directory, sorted by the classes that
+ * cost the most, and the last report can be dumped to the log with SaveGame.DumpProfile.
+ */
+class FSaveGameProfiler
+{
+public:
+	static bool IsEnabled();
+
+	/** Prepares for this many actors, does nothing if profiling is disabled */
+	void Begin(int32 NumActors);
+
+	/** Returns the actor's profile, or nullptr if we're not profiling */
+	FSaveGameActorProfile* GetActor(int32 ActorIdx)
+	{
+		return Actors.IsEmpty() ? nullptr : &Actors[ActorIdx];
+	}
+
+	/**
+	 * Groups the actors by class, then writes the report. Must be called on the game thread once all actors are done.
+	 *
+	 * @param GetActorClass Returns the class of the actor at this index (may be null if the actor is gone)
+	 */
+	void Finish(bool bIsLoading, TFunctionRef<const UClass*(int32)> GetActorClass);
+
+	/** Logs the last report that was written */
+	static void DumpLastReport(FOutputDevice& Ar);
+
+private:
+	TArray<FSaveGameActorProfile> Actors;
+};
+
+/** Adds the time spent in this scope to a profile's counter, does nothing if the counter is null */
+class FSaveGameProfileCycleScope
+{
+public:
+	explicit FSaveGameProfileCycleScope(uint64* InCycles)
+		: Cycles(InCycles)
+		, StartCycles(InCycles ? FPlatformTime::Cycles64() : 0)
+	{}
+
+	~FSaveGameProfileCycleScope()
+	{
+		if (Cycles)
+		{
+			*Cycles += FPlatformTime::Cycles64() - StartCycles;
+		}
+	}
+
+private:
+	uint64* Cycles;
+	uint64 StartCycles;
+};
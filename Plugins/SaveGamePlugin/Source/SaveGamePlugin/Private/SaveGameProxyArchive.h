@@ -28,6 +28,17 @@ struct TSaveGameProxyArchive : public FNameAsStringProxyArchive
 		}
 	}
 
+	/** Properties that are serialized separately (see FSaveGameBulkArrays), so are skipped by tagged serialization */
+	void SetSkippedProperties(TConstArrayView<const FProperty*> Properties)
+	{
+		SkippedProperties = Properties;
+	}
+
+	virtual bool ShouldSkipProperty(const FProperty* InProperty) const override
+	{
+		return SkippedProperties.Contains(InProperty) || FNameAsStringProxyArchive::ShouldSkipProperty(InProperty);
+	}
+
 	virtual FArchive& operator<<(FSoftObjectPath& Value) override
 	{
 		Value.SerializePath(*this);
@@ -83,6 +94,7 @@ struct TSaveGameProxyArchive : public FNameAsStringProxyArchive
 
 private:
 	TMap<FSoftObjectPath, FSoftObjectPath>& Redirects;
+	TConstArrayView<const FProperty*> SkippedProperties;
 
 	template<typename ObjectType>
 	static FSoftObjectPath ToSoftObjectPath(const ObjectType& Value)
@@ -0,0 +1,132 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameQuantizedTransform.h"
+
+namespace SaveGameQuantizedTransform
+{
+	constexpr int32 RotationBits = 20;
+	constexpr uint64 RotationMax = (1ull << RotationBits) - 1;
+	constexpr int32 RotationIndexShift = RotationBits * 3;
+
+	/** The smallest three components are never larger than 1/sqrt(2), so map that range to [0, 1] */
+	uint64 QuantizeRotationComponent(double Value)
+	{
+		const double Normalized = FMath::Clamp((Value * UE_DOUBLE_SQRT_2 + 1.0) * 0.5, 0.0, 1.0);
+		return static_cast<uint64>(FMath::RoundToInt64(Normalized * RotationMax));
+	}
+
+	double DequantizeRotationComponent(uint64 Value)
+	{
+		return (static_cast<double>(Value) / RotationMax * 2.0 - 1.0) * UE_DOUBLE_HALF_SQRT_2;
+	}
+
+	/** Serializes the vector's components as fields, as records have no overhead in binary archives */
+	template<typename VectorType>
+	void SerializeComponents(FStructuredArchive::FSlot Slot, VectorType& Vector)
+	{
+		FStructuredArchive::FRecord Record = Slot.EnterRecord();
+		Record << SA_VALUE(TEXT("X"), Vector.X);
+		Record << SA_VALUE(TEXT("Y"), Vector.Y);
+		Record << SA_VALUE(TEXT("Z"), Vector.Z);
+	}
+}
+
+bool FSaveGameQuantizedTransform::Encode(const FTransform& Transform, const FVector& Origin, float Precision)
+{
+	using namespace SaveGameQuantizedTransform;
+
+	// Location
+	{
+		PrecisionExponent = static_cast<int8>(FMath::Clamp(FMath::FloorToInt32(FMath::Log2(FMath::Max(Precision, UE_SMALL_NUMBER))), -24, 24));
+
+		const FVector Steps = (Transform.GetLocation() - Origin) / FMath::Pow(2.0, static_cast<double>(PrecisionExponent));
+
+		if (Steps.GetAbsMax() >= static_cast<double>(MAX_int32))
+		{
+			return false;
+		}
+
+		Location = FIntVector(FMath::RoundToInt32(Steps.X), FMath::RoundToInt32(Steps.Y), FMath::RoundToInt32(Steps.Z));
+	}
+
+	// Rotation
+	{
+		const FQuat Quat = Transform.GetRotation().GetNormalized();
+		const double Components[4] = { Quat.X, Quat.Y, Quat.Z, Quat.W };
+
+		int32 LargestIdx = 0;
+		for (int32 ComponentIdx = 1; ComponentIdx < 4; ++ComponentIdx)
+		{
+			if (FMath::Abs(Components[ComponentIdx]) > FMath::Abs(Components[LargestIdx]))
+			{
+				LargestIdx = ComponentIdx;
+			}
+		}
+
+		// Q and -Q are the same rotation, so flip the quaternion to keep the largest component positive
+		const double Sign = Components[LargestIdx] < 0.0 ? -1.0 : 1.0;
+
+		Rotation = static_cast<uint64>(LargestIdx) << RotationIndexShift;
+		int32 Shift = RotationIndexShift;
+
+		for (int32 ComponentIdx = 0; ComponentIdx < 4; ++ComponentIdx)
+		{
+			if (ComponentIdx != LargestIdx)
+			{
+				Shift -= RotationBits;
+				Rotation |= QuantizeRotationComponent(Components[ComponentIdx] * Sign) << Shift;
+			}
+		}
+	}
+
+	Scale = FVector3f(Transform.GetScale3D());
+	return true;
+}
+
+FTransform FSaveGameQuantizedTransform::Decode(const FVector& Origin) const
+{
+	using namespace SaveGameQuantizedTransform;
+
+	const FVector DecodedLocation = Origin + FVector(Location) * FMath::Pow(2.0, static_cast<double>(PrecisionExponent));
+
+	const int32 LargestIdx = static_cast<int32>((Rotation >> RotationIndexShift) & 3);
+	double Components[4];
+	double SumOfSquares = 0.0;
+	int32 Shift = RotationIndexShift;
+
+	for (int32 ComponentIdx = 0; ComponentIdx < 4; ++ComponentIdx)
+	{
+		if (ComponentIdx != LargestIdx)
+		{
+			Shift -= RotationBits;
+			Components[ComponentIdx] = DequantizeRotationComponent((Rotation >> Shift) & RotationMax);
+			SumOfSquares += FMath::Square(Components[ComponentIdx]);
+		}
+	}
+
+	Components[LargestIdx] = FMath::Sqrt(FMath::Max(1.0 - SumOfSquares, 0.0));
+	const FQuat DecodedRotation = FQuat(Components[0], Components[1], Components[2], Components[3]).GetNormalized();
+
+	return FTransform(DecodedRotation, DecodedLocation, FVector(Scale));
+}
+
+void FSaveGameQuantizedTransform::Serialize(FStructuredArchive::FSlot Slot)
+{
+	using namespace SaveGameQuantizedTransform;
+
+	FStructuredArchive::FRecord Record = Slot.EnterRecord();
+
+	SerializeComponents(Record.EnterField(TEXT("Location")), Location);
+	Record << SA_VALUE(TEXT("PrecisionExponent"), PrecisionExponent);
+	Record << SA_VALUE(TEXT("Rotation"), Rotation);
+
+	// Most actors aren't scaled, so only store the scale if it isn't uniformly 1
+	if (TOptional<FStructuredArchive::FSlot> ScaleSlot = Record.TryEnterField(TEXT("Scale"), !Scale.Equals(FVector3f::OneVector, 0.0f)))
+	{
+		SerializeComponents(ScaleSlot.GetValue(), Scale);
+	}
+	else if (Slot.GetUnderlyingArchive().IsLoading())
+	{
+		Scale = FVector3f::OneVector;
+	}
+}
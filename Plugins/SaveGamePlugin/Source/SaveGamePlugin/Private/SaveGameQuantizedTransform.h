@@ -0,0 +1,37 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * An actor transform, quantized to about a quarter of the size of an FTransform (see
+ * USaveGameSettings::bQuantizeTransforms):
+ *
+ * - Location: relative to the level's origin, as a whole number of steps. The step is the largest power of two that's
+ *   no larger than the precision, so that the step itself can be stored as an exponent.
+ * - Rotation: "smallest three", the quaternion's largest component is dropped (and rebuilt from the other three, as
+ *   the quaternion is normalized). The remaining three are stored in 20 bits each, with the dropped index above them.
+ * - Scale: only stored if it isn't uniformly 1.
+ */
+struct FSaveGameQuantizedTransform
+{
+	/**
+	 * @param Origin The level's origin, relative to the world's current origin
+	 * @param Precision The largest error in the location, in world units
+	 * @return false if the location is too far from the origin to be quantized at this precision
+	 */
+	bool Encode(const FTransform& Transform, const FVector& Origin, float Precision);
+
+	FTransform Decode(const FVector& Origin) const;
+
+	void Serialize(FStructuredArchive::FSlot Slot);
+
+private:
+	FIntVector Location = FIntVector::ZeroValue;
+	uint64 Rotation = 0;
+	FVector3f Scale = FVector3f::OneVector;
+
+	/** The location's step is 2^PrecisionExponent */
+	int8 PrecisionExponent = 0;
+};
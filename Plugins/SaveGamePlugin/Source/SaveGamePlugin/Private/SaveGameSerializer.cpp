@@ -4,10 +4,15 @@
 
 #include "SaveGameSerializer.h"
 
+#include "SaveGameBulkArrays.h"
+#include "SaveGameClassTraits.h"
+#include "SaveGameCompressedChunks.h"
 #include "SaveGameFunctionLibrary.h"
 #include "SaveGameObject.h"
 #include "SaveGameVersion.h"
 #include "SaveGameProxyArchive.h"
+#include "SaveGameSettings.h"
+#include "SaveGameSlotHeader.h"
 #include "TaskHelpers.inl"
 #include "Formatters/NullArchiveFormatter.h"
 
@@ -15,34 +20,25 @@ constexpr bool bForceSingleThreaded = false;
 #define USE_TEXT_FORMATTER WITH_TEXT_ARCHIVE_SUPPORT
 
 #if USE_TEXT_FORMATTER
-#include "Formatters/JsonOutputArchiveFormatter.h"
-#include "Formatters/ProxyArchiveFormatter.h"
+#include "Formatters/SaveGameArchiveFormatter.h"
 #endif
 
 #include "SaveGameSystem.h"
 #include "PlatformFeatures.h"
 #include "SaveGameSubsystem.h"
 #include "SaveGameThreading.h"
+#include "Algo/Sort.h"
+#include "HAL/IConsoleManager.h"
 #include "Tasks/TaskConcurrencyLimiter.h"
 
 #define LEVEL_SUBPATH_PREFIX TEXT("PersistentLevel.")
 
 using namespace UE::Tasks;
 
-#if USE_TEXT_FORMATTER
-class FSaveGameArchiveFormatter : public FProxyArchiveFormatter
-{
-public:
-	FSaveGameArchiveFormatter(FArchive& InnerArchive, bool bUseNull)
-		: FProxyArchiveFormatter(BinaryFormatter,
-			static_cast<FStructuredArchiveFormatter&>(bUseNull ? FNullArchiveFormatter::Get() : JsonFormatter))
-		, BinaryFormatter(InnerArchive)
-	{}
-
-	FBinaryArchiveFormatter BinaryFormatter;
-	FJsonOutputArchiveFormatter JsonFormatter;
-};
-#endif
+static TAutoConsoleVariable<int32> CVarSaveGameMaxWorkerThreads(
+	TEXT("SaveGame.MaxWorkerThreads"),
+	0,
+	TEXT("Limits how many thread pool threads serialize actors during save and load, or 0 to use all of them."));
 
 template<bool bIsLoading>
 class TSaveGameArchive
@@ -176,6 +172,9 @@ struct TSaveGameSerializer<bIsLoading>::FActorInfo
 	TWeakObjectPtr<AActor> Actor;
 	FString Name;
 
+	/** When saving, the class of a spawned actor, for the actor index */
+	FSoftClassPath Class;
+
 	TArray<uint8> Data;
 	TSaveGameArchive<bIsLoading>* Archive = nullptr;
 
@@ -184,13 +183,17 @@ private:
 };
 
 template <bool bIsLoading>
-TSaveGameSerializer<bIsLoading>::TSaveGameSerializer(USaveGameSubsystem* InSubsystem)
-	: Subsystem(InSubsystem)
+TSaveGameSerializer<bIsLoading>::TSaveGameSerializer(USaveGameSubsystem* InSubsystem, const FString& InSlotName)
+	: FSaveGameSerializer(InSlotName)
+	, Subsystem(InSubsystem)
 	, Archive(Data)
 	, SaveArchive(new TSaveGameArchive<bIsLoading>(Archive, Redirects))
 	, ActorOffsetsOffset(0)
+	, ActorIndexOffset(0)
 	, VersionOffset(0)
 	, ActorsOffset(0)
+	, ColumnsOffset(0)
+	, PhysicsStatesOffset(0)
 {
 	// Ensure that we're using the latest save game version
 	Archive.UsingCustomVersion(FSaveGameVersion::GUID);
@@ -203,8 +206,14 @@ TSaveGameSerializer<bIsLoading>::~TSaveGameSerializer()
 }
 
 template <bool bIsLoading>
-FTask TSaveGameSerializer<bIsLoading>::DoOperation()
+FTask TSaveGameSerializer<bIsLoading>::Prepare()
 {
+	// We may have already been prepared ahead of time (i.e. by USaveGameSubsystem::Prefetch)
+	if (PrepareTask.IsValid())
+	{
+		return PrepareTask;
+	}
+
 	if (ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem())
 	{
 		FTask PreviousTask;
@@ -213,43 +222,144 @@ FTask TSaveGameSerializer<bIsLoading>::DoOperation()
 		{
 			PreviousTask = Launch(UE_SOURCE_LOCATION, [this, SaveSystem]
 			{
+				SetPhase(ESaveGamePhase::Read);
+
+				// Leave the data empty if there's nothing to read, DoOperation will catch this before travelling
 				TArray<uint8> CompressedData;
-				const bool bLoaded = SaveSystem->LoadGame(false, *GetSaveName(), 0, CompressedData);
-				check(bLoaded);
+				if (!SaveSystem->LoadGame(false, *GetSaveName(), 0, CompressedData))
+				{
+					return;
+				}
+
+				SetPhase(ESaveGamePhase::Decompress);
 
-				// Decompress the loaded save game data
+				// Skip past the slot's metadata (if there is any), then decompress the loaded save game data
 				TSaveGameMemoryArchive CompressorArchive(CompressedData);
-				SerializeCompressedData<true>(CompressorArchive, Data);
+				ESaveGameCompression Compression;
+				FSaveGameSlotHeader::Read(CompressorArchive, SlotInfo, &Compression);
+
+				if (Compression == ESaveGameCompression::Chunks)
+				{
+					// Leaves the data empty if it can't be decompressed, which DoOperation will also catch
+					FSaveGameCompressedChunks Chunks;
+					if (Chunks.ReadTable(CompressorArchive))
+					{
+						Chunks.DecompressAll(CompressedData, Data);
+					}
+				}
+				else
+				{
+					SerializeCompressedData<true>(CompressorArchive, Data);
+				}
 			}, PreviousTask);
 		}
 
 		PreviousTask = Launch(UE_SOURCE_LOCATION, [this]
 		{
+			if (bIsLoading && Data.IsEmpty())
+			{
+				return;
+			}
+
 			SerializeVersionOffset();
 			SerializeHeader();
 		}, PreviousTask);
 
 		if (bIsLoading)
 		{
-			PreviousTask = Launch(UE_SOURCE_LOCATION, [this] { SerializeVersions(); }, PreviousTask);
+			PreviousTask = Launch(UE_SOURCE_LOCATION, [this]
+			{
+				if (Data.IsEmpty())
+				{
+					return;
+				}
+
+				SerializeVersions();
+				SerializeColumns();
+				SerializePhysicsStates();
+
+				// Read these before travelling, so that they can be filtered out as soon as the map loads
+				SerializeDestroyedActors();
+
+				// We may be prefetching, so don't count the wait for DoOperation as part of decompressing
+				EndPhase();
+			}, PreviousTask);
+		}
+
+		PrepareTask = PreviousTask;
+	}
+	else
+	{
+		PrepareTask = MakeCompletedTask<void>();
+	}
 
+	return PrepareTask;
+}
+
+template <bool bIsLoading>
+FTask TSaveGameSerializer<bIsLoading>::DoOperation()
+{
+	if (ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem())
+	{
+		FTask PreviousTask = Prepare();
+
+		if (bIsLoading && IsLoadInPlace())
+		{
+			PreviousTask = LaunchGameThread(UE_SOURCE_LOCATION, [this]
+			{
+				if (Data.IsEmpty())
+				{
+					Fail();
+					return;
+				}
+
+				// We're staying in the current world, so its actors are already initialized
+				LevelActors.Build(Subsystem->GetWorld()->GetCurrentLevel());
+			}, PreviousTask);
+		}
+		else if (bIsLoading)
+		{
 			FTaskEvent MapLoadEvent(TEXT("MapLoaded"));
 			LaunchGameThread(UE_SOURCE_LOCATION, [this, MapLoadEvent]() mutable
 			{
 				UWorld* World = Subsystem->GetWorld();
 
-				check(!MapName.IsEmpty());
+				// Either the save game couldn't be read, or its header was, so there's nowhere to travel to
+				if (MapName.IsEmpty())
+				{
+					Fail();
+					MapLoadEvent.Trigger();
+					return;
+				}
+
 				check(!World->IsInSeamlessTravel());
 
+				// Once the map has been loaded, but before its actors are initialized, remove any destroyed actors
+				FWorldDelegates::OnPostWorldInitialization.AddSPLambda(this, [this](UWorld* LoadedWorld, const UWorld::InitializationValues)
+				{
+					if (LoadedWorld->GetOutermost()->GetLoadedPath().GetPackageName() == MapName)
+					{
+						FilterDestroyedActors(LoadedWorld);
+						FWorldDelegates::OnPostWorldInitialization.RemoveAll(this);
+					}
+				});
+
 				// When our map has loaded, continue the serialization process
-				FCoreUObjectDelegates::PostLoadMapWithWorld.AddSPLambda(this, [this, MapLoadEvent](UWorld*) mutable
+				FCoreUObjectDelegates::PostLoadMapWithWorld.AddSPLambda(this, [this, MapLoadEvent](UWorld* LoadedWorld) mutable
 				{
+					// Index the level's actors up front, so that we can find them from any thread
+					LevelActors.Build(LoadedWorld->GetCurrentLevel());
+
 					MapLoadEvent.Trigger();
 
 					const signed int RemovedCount = FCoreUObjectDelegates::PostLoadMapWithWorld.RemoveAll(this);
 					check(RemovedCount == 1);
+
+					// In case the filter never saw our world, the remaining destroyed actors will be destroyed later
+					FWorldDelegates::OnPostWorldInitialization.RemoveAll(this);
 				});
 
+				SetPhase(ESaveGamePhase::MapLoad);
 				World->SeamlessTravel(MapName, true);
 			}, PreviousTask);
 
@@ -259,7 +369,23 @@ FTask TSaveGameSerializer<bIsLoading>::DoOperation()
 
 		PreviousTask = LaunchGameThread(UE_SOURCE_LOCATION, [this]
 		{
-			SerializeDestroyedActors();
+			// Phase boundary: if a newer save (or a load) has come in, we don't need to gather the world
+			if (IsCancelled() || HasFailed())
+			{
+				return;
+			}
+
+			if (bIsLoading)
+			{
+				RestoreDestroyedActors();
+				Subsystem->RestoreSlotInfo(SlotInfo);
+			}
+			else
+			{
+				SerializeDestroyedActors();
+				SlotInfo = Subsystem->GatherSlotInfo();
+			}
+
 			SerializeActors();
 		}, PreviousTask);
 
@@ -267,8 +393,16 @@ FTask TSaveGameSerializer<bIsLoading>::DoOperation()
 		{
 			PreviousTask = Launch(UE_SOURCE_LOCATION, [this]
 			{
+				if (IsCancelled())
+				{
+					return;
+				}
+
+				SetPhase(ESaveGamePhase::Write);
 				MergeSaveData();
 				SerializeVersions();
+				SerializeColumns();
+				SerializePhysicsStates();
 
 				// Go back to the start to override the original version offset
 				Archive.Seek(0);
@@ -278,6 +412,15 @@ FTask TSaveGameSerializer<bIsLoading>::DoOperation()
 
 		PreviousTask = Launch(UE_SOURCE_LOCATION, [this]
 		{
+			// If we were cancelled before merging, the actors' archives will still be open
+			for (FActorInfo& ActorInfo : ActorData)
+			{
+				if (ActorInfo.Archive)
+				{
+					ActorInfo.Archive->Close();
+				}
+			}
+
 			SaveArchive->Close();
 		}, PreviousTask);
 
@@ -288,6 +431,11 @@ FTask TSaveGameSerializer<bIsLoading>::DoOperation()
 #if USE_TEXT_FORMATTER
 			FinishEvents.Add(Launch(UE_SOURCE_LOCATION, [this, SaveSystem]
 			{
+				if (IsCancelled())
+				{
+					return;
+				}
+
 				TArray<uint8> JsonData;
 				FMemoryWriter WriterArchive(JsonData);
 				TSharedRef<TJsonWriter<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TPrettyJsonPrintPolicy<TCHAR>>::Create(&WriterArchive);
@@ -299,10 +447,19 @@ FTask TSaveGameSerializer<bIsLoading>::DoOperation()
 
 			FinishEvents.Add(Launch(UE_SOURCE_LOCATION, [this, SaveSystem]
 			{
-				// Compress the save game data
+				// Last chance to cancel, past this point we'll be replacing the save on disk
+				if (IsCancelled())
+				{
+					return;
+				}
+
+				SlotInfo.MapName = MapName;
+
+				// Write the slot's metadata uncompressed, followed by the compressed save game data
 				TArray<uint8> CompressedData;
 				TSaveGameMemoryArchive CompressorArchive(CompressedData);
-				SerializeCompressedData<false>(CompressorArchive, Data);
+				FSaveGameSlotHeader::Write(CompressorArchive, SlotInfo);
+				FSaveGameCompressedChunks::Write(CompressorArchive, Data);
 
 				const bool bSaved = SaveSystem->SaveGame(false, *GetSaveName(), 0, CompressedData);
 				check(bSaved);
@@ -311,18 +468,12 @@ FTask TSaveGameSerializer<bIsLoading>::DoOperation()
 			PreviousTask = Launch(UE_SOURCE_LOCATION, []{}, Prerequisites(FinishEvents), ETaskPriority::Default, EExtendedTaskPriority::Inline);
 		}
 
-		return PreviousTask;
+		return Launch(UE_SOURCE_LOCATION, [this] { EndPhase(); }, PreviousTask, ETaskPriority::Default, EExtendedTaskPriority::Inline);
 	}
 
 	return MakeCompletedTask<void>();
 }
 
-template <bool bIsLoading>
-FString TSaveGameSerializer<bIsLoading>::GetSaveName()
-{
-	return TEXT("SaveGame");
-}
-
 template <bool bIsLoading>
 void TSaveGameSerializer<bIsLoading>::SerializeVersionOffset()
 {
@@ -365,24 +516,37 @@ void TSaveGameSerializer<bIsLoading>::SerializeHeader()
 	Record << SA_VALUE(TEXT("Map"), MapName);
 }
 
-template<typename FuncType>
-void ExecuteJobs(const int32 NumJobs, TStatId StatId, FuncType&& Job)
+/**
+ * Runs the jobs across the thread pool, while the calling (game) thread runs the tasks that they queue.
+ * OnStarted is called once the queue has been set up, so anything it queues (i.e. a phase change notification)
+ * is run while the jobs are, rather than once the game thread gets back to the task graph.
+ */
+template<typename StartFuncType, typename FuncType>
+void ExecuteJobs(const int32 NumJobs, TStatId StatId, StartFuncType&& OnStarted, FuncType&& Job)
 {
-	FSaveGameTheadScope GameThreadScope;
+	FSaveGameTheadScope GameThreadScope(NumJobs);
+	ISaveGameThreadQueue& ThreadQueue = GameThreadScope.GetQueue();
+	OnStarted();
+
 	TAtomic<int32> JobIdx = 0;
 	TAtomic<int32> CompletedJobs = 0;
 
-	const int32 NumThreads = GThreadPool->GetNumThreads();
+	const int32 MaxThreads = CVarSaveGameMaxWorkerThreads.GetValueOnAnyThread();
+	const int32 NumThreads = MaxThreads > 0 ? FMath::Min(MaxThreads, GThreadPool->GetNumThreads()) : GThreadPool->GetNumThreads();
+
 	for (int32 ThreadIdx = 0; ThreadIdx < NumThreads; ++ThreadIdx)
 	{
 		GThreadPool->AddQueuedWork(new TAsyncQueuedWork<void>([&]
 		{
 			FScopeCycleCounter Counter(StatId);
 
+			// Anything that queues game thread work from this worker should use this operation's queue
+			FSaveGameThreadQueueContext QueueContext(ThreadQueue);
+
 			int32 OurJobIdx;
 			while ((OurJobIdx = JobIdx.IncrementExchange()) < NumJobs)
 			{
-				Job(OurJobIdx);
+				Job(ThreadQueue, OurJobIdx);
 				++CompletedJobs;
 			}
 		}, TPromise<void>()), EQueuedWorkPriority::Highest);
@@ -395,6 +559,11 @@ void ExecuteJobs(const int32 NumJobs, TStatId StatId, FuncType&& Job)
 		// Pump the Work Queue on the game thread
 		while (GameThreadScope.ProcessThread(10000) || CompletedJobs.Load() < NumJobs);
 	}
+	else
+	{
+		// The jobs didn't queue anything, but OnStarted may have
+		GameThreadScope.ProcessThread(0);
+	}
 
 	check(CompletedJobs.Load() >= NumJobs);
 }
@@ -411,37 +580,36 @@ void TSaveGameSerializer<bIsLoading>::SerializeActors()
 	const UWorld* World = Subsystem->GetWorld();
 	LevelAssetPath = FTopLevelAssetPath(World->GetCurrentLevel()->GetPackage()->GetFName(), World->GetCurrentLevel()->GetOuter()->GetFName());
 
-	SaveGameActors = Subsystem->SaveGameActors.Array();
-	int32 NumActors = SaveGameActors.Num();
+	Subsystem->SaveGameActors.GetActors(SaveGameActors);
 
-	if (bIsLoading)
+	if (!bIsLoading)
 	{
-		QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_CollectSpawnIDs);
+		SortActors();
+		Columns.AssignRows(SaveGameActors, ColumnRows);
 
-		// Iterate through our live actors so that we can map their SpawnIDs
-		for (const TWeakObjectPtr<AActor>& ActorPtr : SaveGameActors)
+		if (GetDefault<USaveGameSettings>()->bSavePhysicsStates)
 		{
-			AActor* Actor = ActorPtr.Get();
-			if (IsValid(Actor) && Actor->Implements<USaveGameSpawnActor>())
-			{
-				const FGuid SpawnID = ISaveGameSpawnActor::Execute_GetSpawnID(Actor);
-
-				if (SpawnID.IsValid())
-				{
-					SpawnIDs.Add(SpawnID, Actor);
-				}
-			}
+			PhysicsStates.Capture(SaveGameActors);
 		}
 	}
+	int32 NumActors = SaveGameActors.Num();
 
 	ActorOffsets.SetNumZeroed(NumActors);
 	ActorOffsetsOffset = Archive.Tell();
+
+	// Where the index of the actors' names and classes will be, only FSaveGameFileView needs this
+	if (!bIsLoading || Archive.CustomVer(FSaveGameVersion::GUID) >= FSaveGameVersion::ActorIndex)
+	{
+		Archive << ActorIndexOffset;
+	}
+
 	Archive << ActorOffsets;
 
 	// We do this as in a load game, we will have the number of actors from the actor offets
 	NumActors = ActorOffsets.Num();
 	SaveGameActors.SetNumZeroed(NumActors);
 	ActorData.SetNumZeroed(NumActors);
+	Profiler.Begin(NumActors);
 
 	ActorsOffset = Archive.Tell();
 	FStructuredArchive::FStream ActorStream = SaveArchive->GetRecord().EnterStream(TEXT("Actors"));
@@ -449,32 +617,178 @@ void TSaveGameSerializer<bIsLoading>::SerializeActors()
 	// Need to init actors first for the sake of populating redirects before serialization
 	{
 		QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_InitializeActors);
+		ExecuteJobs(NumActors, GET_STATID(STAT_SaveGame_InitializeActors), [this, NumActors]
+		{
+			SetPhase(ESaveGamePhase::InitializeActors, NumActors);
+		},
+		[this] (ISaveGameThreadQueue& ThreadQueue, int32 ActorIdx)
+		{
+			InitializeActor(ThreadQueue, ActorIdx);
+			AddCompletedActor();
+		});
+	}
 
-		ExecuteJobs(NumActors, GET_STATID(STAT_SaveGame_InitializeActors), [this] (int32 ActorIdx) { InitializeActor(ActorIdx); });
+	if (bIsLoading)
+	{
+		// Now that the actors' classes are loaded, match the columns to their properties
+		Columns.ResolveProperties();
+		TransformBatch.Reset(NumActors);
 	}
 
 	// Actually do the serialization of each actor (now that we've updated redirects)
 	{
 		QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_Serialize);
-
-		ExecuteJobs(NumActors, GET_STATID(STAT_SaveGame_Serialize), [this] (int32 ActorIdx) { SerializeActor(ActorIdx); });
+		ExecuteJobs(NumActors, GET_STATID(STAT_SaveGame_Serialize), [this, NumActors]
+		{
+			SetPhase(ESaveGamePhase::SerializeActors, NumActors);
+		},
+		[this] (ISaveGameThreadQueue& ThreadQueue, int32 ActorIdx)
+		{
+			SerializeActor(ThreadQueue, ActorIdx);
+			AddCompletedActor();
+		});
 	}
 
 	if (bIsLoading)
 	{
+		// Every actor has been serialized (including their game thread tasks), so move them all in one pass
+		TransformBatch.Apply();
+		PhysicsStates.Restore(SaveGameActors);
+
 		for (FActorInfo& ActorInfo : ActorData)
 		{
 			ActorInfo.Archive->Close();
 		}
 	}
+
+	Profiler.Finish(bIsLoading, [this](int32 ActorIdx) -> const UClass*
+	{
+		const AActor* Actor = ActorData[ActorIdx].Actor.Get();
+		return Actor ? Actor->GetClass() : nullptr;
+	});
+}
+
+/** Orders actors by their level, then by their name (which is unique within the level) */
+static bool ActorNameLess(const TWeakObjectPtr<AActor>& A, const TWeakObjectPtr<AActor>& B)
+{
+	const AActor* ActorA = A.Get();
+	const AActor* ActorB = B.Get();
+
+	if (!ActorA || !ActorB)
+	{
+		return ActorA != nullptr;
+	}
+
+	const int32 LevelCompare = ActorA->GetLevel()->GetOutermost()->GetFName().Compare(ActorB->GetLevel()->GetOutermost()->GetFName());
+	return LevelCompare != 0 ? LevelCompare < 0 : ActorA->GetFName().Compare(ActorB->GetFName()) < 0;
+}
+
+/** Interleaves the lower 21 bits of a value with two zero bits, for a 3D Morton code */
+static uint64 SpreadMortonBits(uint64 Value)
+{
+	Value &= 0x1fffff;
+	Value = (Value | Value << 32) & 0x1f00000000ffff;
+	Value = (Value | Value << 16) & 0x1f0000ff0000ff;
+	Value = (Value | Value << 8) & 0x100f00f00f00f00f;
+	Value = (Value | Value << 4) & 0x10c30c30c30c30c3;
+	Value = (Value | Value << 2) & 0x1249249249249249;
+	return Value;
+}
+
+/** Groups actors by class, then by location, falling back to their names */
+static void SortActorsByClassAndLocation(TArray<TWeakObjectPtr<AActor>>& Actors)
+{
+	struct FActorKey
+	{
+		TWeakObjectPtr<AActor> Actor;
+		const UClass* Class;
+		uint64 MortonCode;
+	};
+
+	FBox Bounds(ForceInit);
+	for (const TWeakObjectPtr<AActor>& Actor : Actors)
+	{
+		if (const AActor* ActorPtr = Actor.Get())
+		{
+			Bounds += ActorPtr->GetActorLocation();
+		}
+	}
+
+	constexpr double MaxCoordinate = (1 << 21) - 1;
+	const FVector Scale = Bounds.IsValid ? FVector(MaxCoordinate) / Bounds.GetSize().ComponentMax(FVector(UE_KINDA_SMALL_NUMBER)) : FVector::ZeroVector;
+
+	TArray<FActorKey> Keys;
+	Keys.Reserve(Actors.Num());
+
+	for (const TWeakObjectPtr<AActor>& Actor : Actors)
+	{
+		FActorKey& Key = Keys.Add_GetRef({ Actor, nullptr, 0 });
+
+		if (const AActor* ActorPtr = Actor.Get())
+		{
+			const FVector Coordinates = (ActorPtr->GetActorLocation() - Bounds.Min) * Scale;
+
+			Key.Class = ActorPtr->GetClass();
+			Key.MortonCode = SpreadMortonBits(static_cast<uint64>(Coordinates.X))
+				| SpreadMortonBits(static_cast<uint64>(Coordinates.Y)) << 1
+				| SpreadMortonBits(static_cast<uint64>(Coordinates.Z)) << 2;
+		}
+	}
+
+	Algo::Sort(Keys, [](const FActorKey& A, const FActorKey& B)
+	{
+		if (A.Class != B.Class)
+		{
+			if (!A.Class || !B.Class)
+			{
+				return A.Class != nullptr;
+			}
+
+			// Compare by name rather than pointer, so that the order doesn't change between runs
+			const int32 ClassCompare = A.Class->GetFName().Compare(B.Class->GetFName());
+			if (ClassCompare != 0)
+			{
+				return ClassCompare < 0;
+			}
+
+			return A.Class->GetOutermost()->GetFName().Compare(B.Class->GetOutermost()->GetFName()) < 0;
+		}
+
+		return A.MortonCode != B.MortonCode ? A.MortonCode < B.MortonCode : ActorNameLess(A.Actor, B.Actor);
+	});
+
+	for (int32 ActorIdx = 0; ActorIdx < Keys.Num(); ++ActorIdx)
+	{
+		Actors[ActorIdx] = Keys[ActorIdx].Actor;
+	}
 }
 
 template <bool bIsLoading>
-void TSaveGameSerializer<bIsLoading>::InitializeActor(int32 ActorIdx)
+void TSaveGameSerializer<bIsLoading>::SortActors()
 {
-	const FString EventStr = FString::Printf(TEXT("InitializeActor: %i"), ActorIdx);
-	SCOPED_NAMED_EVENT_FSTRING(EventStr, FColor::Red);
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_SortActors);
+
+	check(!bIsLoading && IsInGameThread());
 
+	switch (GetDefault<USaveGameSettings>()->ActorOrder)
+	{
+	case ESaveGameActorOrder::Deterministic:
+		Algo::Sort(SaveGameActors, &ActorNameLess);
+		break;
+
+	case ESaveGameActorOrder::Clustered:
+		SortActorsByClassAndLocation(SaveGameActors);
+		break;
+
+	case ESaveGameActorOrder::Registration:
+	default:
+		break;
+	}
+}
+
+template <bool bIsLoading>
+void TSaveGameSerializer<bIsLoading>::InitializeActor(ISaveGameThreadQueue& ThreadQueue, int32 ActorIdx)
+{
 	FSoftClassPath Class;
 	FGuid SpawnID;
 	FActorInfo& ActorInfo = ActorData[ActorIdx];
@@ -499,14 +813,26 @@ void TSaveGameSerializer<bIsLoading>::InitializeActor(int32 ActorIdx)
 		{
 			// We're a spawned actor, stash the class
 			Class = Actor->GetClass();
+			ActorInfo.Class = Class;
 		}
 
-		if (Actor->Implements<USaveGameSpawnActor>())
+		if (FSaveGameClassTraits::Get(Actor).bIsSpawnActor)
 		{
 			SpawnID = ISaveGameSpawnActor::Execute_GetSpawnID(Actor);
 		}
 	}
 
+	TRACE_SAVEGAME_ACTOR_SCOPE(TraceScope, InitializeActor, bIsLoading, ActorIdx, ActorInfo.Archive->GetArchive());
+	TRACE_SAVEGAME_ACTOR_CLASS(TraceScope, ActorInfo.Actor.IsValid() ? ActorInfo.Actor->GetClass() : nullptr);
+
+	// Where the actor's custom data starts, relative to the start of the actor. This isn't known until we've
+	// serialized its properties, so when saving, reserve its space now (see FSaveGameFileView for its use).
+	if (!bIsLoading || Archive.CustomVer(FSaveGameVersion::GUID) >= FSaveGameVersion::ActorDataOffsets)
+	{
+		uint64 DataOffset = 0;
+		ActorInfo.Archive->GetArchive() << DataOffset;
+	}
+
 	FStructuredArchive::FRecord& Record = ActorInfo.Archive->GetRecord();
 
 	Record.EnterField(TEXT("Name")) << ActorInfo.Name;
@@ -525,7 +851,18 @@ void TSaveGameSerializer<bIsLoading>::InitializeActor(int32 ActorIdx)
 		GuidSlot.GetValue() << SpawnID;
 	}
 
-	if (bIsLoading)
+	if (bIsLoading && Class.IsNull() && !SpawnID.IsValid())
+	{
+		// This is a loaded actor (is a level actor), we can find it without going to the game thread
+		AActor* Actor = LevelActors.Find(ActorInfo.Name);
+		check(Actor);
+
+		ActorInfo.Actor = Actor;
+		SaveGameActors[ActorIdx] = Actor;
+
+		TRACE_SAVEGAME_ACTOR_CLASS(TraceScope, Actor->GetClass());
+	}
+	else if (bIsLoading)
 	{
 		ISaveGameThreadQueue::FTaskFunction SpawnOrGetActor = [this, ActorIdx, Class, SpawnID]
 		{
@@ -538,11 +875,13 @@ void TSaveGameSerializer<bIsLoading>::InitializeActor(int32 ActorIdx)
 				ensureAlways(!ActorInfo.Name.IsEmpty());
 
 				// This is a loaded actor (is a level actor), let's find it
-				Actor = FindObjectFast<AActor>(World->GetCurrentLevel(), *ActorInfo.Name);
+				Actor = LevelActors.Find(ActorInfo.Name);
 			}
-			else if (SpawnID.IsValid() && SpawnIDs.Contains(SpawnID))
+			else if (const TWeakObjectPtr<AActor>* SpawnedActor = SpawnID.IsValid() ? Subsystem->SpawnIDs.Find(SpawnID) : nullptr;
+				SpawnedActor && SpawnedActor->IsValid())
 			{
-				Actor = SpawnIDs[SpawnID];
+				// The subsystem keeps its SpawnID index up to date, so this actor already exists
+				Actor = *SpawnedActor;
 			}
 			else
 			{
@@ -561,9 +900,12 @@ void TSaveGameSerializer<bIsLoading>::InitializeActor(int32 ActorIdx)
 
 				Actor = World->SpawnActor(ActorClass, nullptr, nullptr, SpawnParameters);
 
-				if (SpawnID.IsValid() && Actor->Implements<USaveGameSpawnActor>())
+				if (SpawnID.IsValid() && FSaveGameClassTraits::Get(ActorClass).bIsSpawnActor)
 				{
+					// Re-index the actor, as it will have been indexed with its initial SpawnID when spawned
+					Subsystem->RemoveSpawnID(Actor.Get());
 					ISaveGameSpawnActor::Execute_SetSpawnID(Actor.Get(), SpawnID);
+					Subsystem->AddSpawnID(Actor.Get());
 				}
 			}
 
@@ -586,13 +928,18 @@ void TSaveGameSerializer<bIsLoading>::InitializeActor(int32 ActorIdx)
 		}
 		else
 		{
-			ISaveGameThreadQueue::Get().AddTask(Forward<ISaveGameThreadQueue::FTaskFunction>(SpawnOrGetActor));
+			if (FSaveGameActorProfile* Profile = Profiler.GetActor(ActorIdx))
+			{
+				Profile->NumGameThreadTasks++;
+			}
+
+			ThreadQueue.AddTask(MoveTemp(SpawnOrGetActor));
 		}
 	}
 }
 
 template <bool bIsLoading>
-void TSaveGameSerializer<bIsLoading>::SerializeActor(int32 ActorIdx)
+void TSaveGameSerializer<bIsLoading>::SerializeActor(ISaveGameThreadQueue& ThreadQueue, int32 ActorIdx)
 {
 	check(bForceSingleThreaded || !IsInGameThread());
 
@@ -601,34 +948,110 @@ void TSaveGameSerializer<bIsLoading>::SerializeActor(int32 ActorIdx)
 	FActorInfo& ActorInfo = ActorData[ActorIdx];
 	const AActor* Actor = ActorInfo.Actor.Get();
 	FStructuredArchive::FRecord& Record = ActorInfo.Archive->GetRecord();
+	FSaveGameActorProfile* Profile = Profiler.GetActor(ActorIdx);
+
+	{
+		TRACE_SAVEGAME_ACTOR_SCOPE(TraceScope, SerializeProperties, bIsLoading, ActorIdx, ActorInfo.Archive->GetArchive());
+		TRACE_SAVEGAME_ACTOR_CLASS(TraceScope, Actor->GetClass());
+		FSaveGameProfileCycleScope ProfileScope(Profile ? &Profile->PropertiesCycles : nullptr);
 
-	// Since we have control of the game thread, we should be pretty safe to serialize our properties
-	Actor->SerializeScriptProperties(Record.EnterField(TEXT("Properties")));
+		int32 Row = bIsLoading ? INDEX_NONE : ColumnRows[ActorIdx];
+
+		// Rows are only stored when the save has columns (which older saves never do), so other saves don't pay for them
+		if (!Columns.IsEmpty())
+		{
+			if (TOptional<FStructuredArchive::FSlot> RowSlot = Record.TryEnterField(TEXT("Row"), Row != INDEX_NONE))
+			{
+				RowSlot.GetValue() << Row;
+			}
+		}
 
-	ISaveGameThreadQueue::FTaskFunction CallOnSerialize = [this, ActorIdx]
+		if (Row != INDEX_NONE && bIsLoading)
+		{
+			Columns.ReadRow(ActorInfo.Actor.Get(), Row);
+		}
+		else if (Row != INDEX_NONE)
+		{
+			Columns.WriteRow(Actor, Row);
+		}
+		else
+		{
+			const TSharedPtr<const TArray<const FProperty*>> BulkArrayPropertiesPtr = FSaveGameClassTraits::Get(Actor).BulkArrayProperties;
+			const TConstArrayView<const FProperty*> BulkArrayProperties = BulkArrayPropertiesPtr.IsValid() ? TConstArrayView<const FProperty*>(*BulkArrayPropertiesPtr) : TConstArrayView<const FProperty*>();
+
+			// When loading, bulk arrays won't have been saved as tagged properties, so there's nothing to skip
+			TSaveGameProxyArchive<bIsLoading>& ProxyArchive = ActorInfo.Archive->GetArchive();
+			ProxyArchive.SetSkippedProperties(bIsLoading ? TConstArrayView<const FProperty*>() : BulkArrayProperties);
+
+			// Since we have control of the game thread, we should be pretty safe to serialize our properties
+			Actor->SerializeScriptProperties(Record.EnterField(TEXT("Properties")));
+
+			ProxyArchive.SetSkippedProperties({});
+
+			if (!bIsLoading || Archive.CustomVer(FSaveGameVersion::GUID) >= FSaveGameVersion::BulkArrays)
+			{
+				if (TOptional<FStructuredArchive::FSlot> BulkArraysSlot = Record.TryEnterField(TEXT("BulkArrays"), !BulkArrayProperties.IsEmpty()))
+				{
+					FSaveGameBulkArrays::Serialize(BulkArraysSlot.GetValue(), ActorInfo.Actor.Get(), BulkArrayProperties);
+				}
+			}
+		}
+	}
+
+	ISaveGameThreadQueue::FTaskFunction CallOnSerialize = [this, ActorIdx, Profile, &ThreadQueue]
 	{
 		QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_OnSerialize);
 
 		FActorInfo& ActorInfo = ActorData[ActorIdx];
 		AActor* Actor = ActorInfo.Actor.Get();
 		FStructuredArchive::FRecord& Record = ActorInfo.Archive->GetRecord();
-		FStructuredArchive::FSlot CustomDataSlot = Record.EnterField(TEXT("Data"));
-		FStructuredArchive::FRecord CustomDataRecord = CustomDataSlot.EnterRecord();
 
-		// Encapsulate the record in something a Blueprint can access
-		FSaveGameArchive SaveGameArchive(CustomDataRecord, Actor);
+		TRACE_SAVEGAME_ACTOR_SCOPE(TraceScope, OnSerialize, bIsLoading, ActorIdx, ActorInfo.Archive->GetArchive());
+		TRACE_SAVEGAME_ACTOR_CLASS(TraceScope, Actor->GetClass());
 
-		ISaveGameObject::Execute_OnSerialize(Actor, SaveGameArchive, bIsLoading);
+		if (!bIsLoading)
+		{
+			// Fill in the offset that was reserved at the start of this actor
+			FArchive& ActorArchive = ActorInfo.Archive->GetArchive();
+			uint64 DataOffset = ActorArchive.Tell();
+			ActorArchive.Seek(0);
+			ActorArchive << DataOffset;
+			ActorArchive.Seek(DataOffset);
+		}
+
+		{
+			FSaveGameProfileCycleScope ProfileScope(Profile ? &Profile->OnSerializeCycles : nullptr);
+
+			FStructuredArchive::FSlot CustomDataSlot = Record.EnterField(TEXT("Data"));
+			FStructuredArchive::FRecord CustomDataRecord = CustomDataSlot.EnterRecord();
+
+			// Encapsulate the record in something a Blueprint can access
+			FSaveGameArchive SaveGameArchive(CustomDataRecord, Actor, &ThreadQueue, bIsLoading ? &TransformBatch : nullptr, ActorIdx);
+
+			ISaveGameObject::Execute_OnSerialize(Actor, SaveGameArchive, bIsLoading);
+		}
+
+		if (Profile)
+		{
+			// Now that the custom data's archive has closed, we're at the end of this actor
+			const uint64 ActorStart = bIsLoading ? ActorOffsets[ActorIdx] : 0;
+			Profile->Bytes = ActorInfo.Archive->GetArchive().Tell() - ActorStart;
+		}
 	};
 
-	if (bForceSingleThreaded || ISaveGameObject::Execute_IsThreadSafe(Actor))
+	if (bForceSingleThreaded || FSaveGameClassTraits::Get(Actor).bIsThreadSafe)
 	{
 		CallOnSerialize();
 	}
 	else
 	{
+		if (Profile)
+		{
+			Profile->NumGameThreadTasks++;
+		}
+
 		// We're not threadsafe, queue up this actor to the game thread
-		ISaveGameThreadQueue::Get().AddTask(Forward<ISaveGameThreadQueue::FTaskFunction>(CallOnSerialize));
+		ThreadQueue.AddTask(MoveTemp(CallOnSerialize));
 	}
 }
 
@@ -640,10 +1063,17 @@ void TSaveGameSerializer<bIsLoading>::MergeSaveData()
 	Archive.Seek(ActorsOffset);
 	FStructuredArchive::FStream ActorStream = SaveArchive->GetRecord().EnterStream(TEXT("Actors"));
 
+	TArray<FString> ActorNames;
+	TArray<FString> ActorClasses;
+	ActorNames.Reserve(ActorData.Num());
+	ActorClasses.Reserve(ActorData.Num());
+
 	// Merge each actor's save data
 	for (int32 ActorIdx = 0; ActorIdx < ActorData.Num(); ++ActorIdx)
 	{
 		FActorInfo& ActorInfo = ActorData[ActorIdx];
+		ActorNames.Add(ActorInfo.Name);
+		ActorClasses.Add(ActorInfo.Class.ToString());
 
 		ActorInfo.Archive->Close();
 		SaveArchive->ConsolidateVersions(*ActorInfo.Archive);
@@ -669,7 +1099,14 @@ void TSaveGameSerializer<bIsLoading>::MergeSaveData()
 
 	ActorData.Empty();
 
+	// The actor index follows the actors, so that FSaveGameFileView can list them without visiting each one
+	Archive.Seek(Data.Num());
+	ActorIndexOffset = Data.Num();
+	Archive << ActorNames;
+	Archive << ActorClasses;
+
 	Archive.Seek(ActorOffsetsOffset);
+	Archive << ActorIndexOffset;
 	Archive << ActorOffsets;
 	Archive.Seek(Data.Num());
 }
@@ -679,53 +1116,87 @@ void TSaveGameSerializer<bIsLoading>::SerializeDestroyedActors()
 {
 	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_SerializeDestroyedActors);
 
-	check(IsInGameThread());
-	const UWorld* World = Subsystem->GetWorld();
-
-	int32 NumDestroyedActors;
+	// When saving, we're reading the subsystem's destroyed actors, so must be on the game thread
+	check(bIsLoading || IsInGameThread());
 
 	if (!bIsLoading)
 	{
-		NumDestroyedActors = Subsystem->DestroyedLevelActors.Num();
+		DestroyedActorNames.Reset(Subsystem->DestroyedLevelActors.Num());
+
+		for (const FSoftObjectPath& DestroyedActorPath : Subsystem->DestroyedLevelActors)
+		{
+			// Only store the object name without the prefix and full path
+			FString ActorSubPath = DestroyedActorPath.GetSubPathString();
+			ActorSubPath.RemoveFromStart(LEVEL_SUBPATH_PREFIX);
+			DestroyedActorNames.Add(*ActorSubPath);
+		}
+
+		// The subsystem keeps these in a set, so their order depends on its hashing
+		if (GetDefault<USaveGameSettings>()->ActorOrder != ESaveGameActorOrder::Registration)
+		{
+			Algo::Sort(DestroyedActorNames, FNameLexicalLess());
+		}
 	}
 
+	int32 NumDestroyedActors = DestroyedActorNames.Num();
 	FStructuredArchive::FArray DestroyedActorsArray = SaveArchive->GetRecord().EnterArray(TEXT("DestroyedActors"), NumDestroyedActors);
 
 	if (bIsLoading)
 	{
-		// Allocate our expected number of actors
-		Subsystem->DestroyedLevelActors.Reset();
-		Subsystem->DestroyedLevelActors.Reserve(NumDestroyedActors);
+		DestroyedActorNames.SetNum(NumDestroyedActors);
 	}
 
-	auto DestroyedActorsIt = Subsystem->DestroyedLevelActors.CreateConstIterator();
-	for (int32 ActorIdx = 0; ActorIdx < NumDestroyedActors; ++ActorIdx)
+	for (FName& ActorName : DestroyedActorNames)
 	{
-		FName ActorName;
+		DestroyedActorsArray.EnterElement() << ActorName;
+	}
+}
 
-		if (!bIsLoading)
-		{
-			// Only store the object name without the prefix and full path
-			FString ActorSubPath = (*DestroyedActorsIt).GetSubPathString();
-			ActorSubPath.RemoveFromStart(LEVEL_SUBPATH_PREFIX);
-			ActorName = *ActorSubPath;
+template <bool bIsLoading>
+void TSaveGameSerializer<bIsLoading>::FilterDestroyedActors(UWorld* World)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_FilterDestroyedActors);
+
+	check(bIsLoading && IsInGameThread());
 
-			++DestroyedActorsIt;
+	// The world's actors haven't been initialized yet (no registered components, no BeginPlay),
+	// so destroying them now is much cheaper than letting them fully initialize first
+	for (const FName& ActorName : DestroyedActorNames)
+	{
+		if (AActor* DestroyedActor = FindObjectFast<AActor>(World->PersistentLevel, ActorName))
+		{
+			World->DestroyActor(DestroyedActor);
 		}
+	}
+}
 
-		DestroyedActorsArray.EnterElement() << ActorName;
+template <bool bIsLoading>
+void TSaveGameSerializer<bIsLoading>::RestoreDestroyedActors()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_RestoreDestroyedActors);
 
-		if (bIsLoading)
+	check(bIsLoading && IsInGameThread());
+
+	const ULevel* Level = Subsystem->GetWorld()->GetCurrentLevel();
+	const FTopLevelAssetPath CurrentLevelPath(Level->GetPackage()->GetFName(), Level->GetOuter()->GetFName());
+
+	// Allocate our expected number of actors
+	Subsystem->DestroyedLevelActors.Reset();
+	Subsystem->DestroyedLevelActors.Reserve(DestroyedActorNames.Num());
+
+	for (const FName& ActorName : DestroyedActorNames)
+	{
+		// Should have been filtered out on load, but if not, destroy it now
+		if (AActor* DestroyedActor = LevelActors.Find(ActorName))
 		{
-			// Find the live actor in the level
-			if (AActor* DestroyedActor = FindObjectFast<AActor>(World->GetCurrentLevel(), ActorName))
-			{
-				// Be sure to add any valid destroyed actors back into the array for saving later!
-				Subsystem->DestroyedLevelActors.Add(DestroyedActor);
-				DestroyedActor->Destroy();
-			}
+			DestroyedActor->Destroy();
 		}
+
+		// Be sure to add the destroyed actors back into the array for saving later!
+		Subsystem->DestroyedLevelActors.Add(FSoftObjectPath(CurrentLevelPath, LEVEL_SUBPATH_PREFIX + ActorName.ToString()));
 	}
+
+	DestroyedActorNames.Empty();
 }
 
 template <bool bIsLoading>
@@ -754,11 +1225,77 @@ void TSaveGameSerializer<bIsLoading>::SerializeVersions()
 		// Assign our serialized versions
 		Archive.SetCustomVersions(VersionContainer);
 
+		// The columns (if there are any) are written straight after the versions
+		ColumnsOffset = Archive.Tell();
+
 		// After serializing versions, go back to initial position
 		Archive.Seek(InitialPosition);
 	}
 }
 
+template <bool bIsLoading>
+void TSaveGameSerializer<bIsLoading>::SerializeColumns()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_SerializeColumnsSection);
+
+	const uint64 InitialPosition = Archive.Tell();
+
+	if (bIsLoading)
+	{
+		if (Archive.CustomVer(FSaveGameVersion::GUID) < FSaveGameVersion::ColumnarProperties)
+		{
+			return;
+		}
+
+		Archive.Seek(ColumnsOffset);
+	}
+
+	Columns.Serialize(SaveArchive->GetRecord().EnterField(TEXT("Columns")));
+
+	if (bIsLoading)
+	{
+		// The physics states are written straight after the columns
+		PhysicsStatesOffset = Archive.Tell();
+
+		Archive.Seek(InitialPosition);
+	}
+}
+
+template <bool bIsLoading>
+void TSaveGameSerializer<bIsLoading>::SerializePhysicsStates()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_SerializePhysicsStatesSection);
+
+	const uint64 InitialPosition = Archive.Tell();
+
+	if (bIsLoading)
+	{
+		if (Archive.CustomVer(FSaveGameVersion::GUID) < FSaveGameVersion::PhysicsStates)
+		{
+			return;
+		}
+
+		Archive.Seek(PhysicsStatesOffset);
+	}
+
+	PhysicsStates.Serialize(SaveArchive->GetRecord().EnterField(TEXT("PhysicsStates")));
+
+	if (bIsLoading)
+	{
+		Archive.Seek(InitialPosition);
+	}
+}
+
 // Instantiate the permutations of TSaveGameSerializer
 template TSaveGameSerializer<false>;
 template TSaveGameSerializer<true>;
+
+TSharedRef<FSaveGameSerializer> FSaveGameSerializer::Create(USaveGameSubsystem* Subsystem, const FString& SlotName, bool bIsLoading)
+{
+	if (bIsLoading)
+	{
+		return MakeShared<TSaveGameSerializer<true>>(Subsystem, SlotName);
+	}
+
+	return MakeShared<TSaveGameSerializer<false>>(Subsystem, SlotName);
+}
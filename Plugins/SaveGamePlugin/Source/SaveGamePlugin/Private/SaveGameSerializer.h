@@ -2,9 +2,21 @@
 
 #pragma once
 
+#include "SaveGameColumns.h"
+#include "SaveGameLevelActorIndex.h"
+#include "SaveGamePhysicsStates.h"
+#include "SaveGameOperation.h"
+#include "SaveGameProfiler.h"
+#include "SaveGameSlotInfo.h"
+#include "SaveGameTrace.h"
+#include "SaveGameTransformBatch.h"
+
 #include "Templates/ChooseClass.h"
 #include "Tasks/Task.h"
 
+#include <atomic>
+
+class ISaveGameThreadQueue;
 class USaveGameSubsystem;
 
 template <bool bIsLoading> class TSaveGameArchive;
@@ -12,26 +24,123 @@ template <bool bIsLoading> class TSaveGameArchive;
 class FSaveGameSerializer :  public TSharedFromThis<FSaveGameSerializer>
 {
 public:
+	FSaveGameSerializer(const FString& InSlotName)
+		: SlotName(InSlotName)
+	{}
+
 	virtual ~FSaveGameSerializer() = default;
 
+	/** Creates a save or a load, for modules that can't instantiate TSaveGameSerializer (i.e. the benchmark) */
+	static SAVEGAMEPLUGIN_API TSharedRef<FSaveGameSerializer> Create(USaveGameSubsystem* Subsystem, const FString& SlotName, bool bIsLoading);
+
 	virtual bool IsLoading() const = 0;
+
+	/**
+	 * Starts the steps that don't need the world, like reading, decompressing and parsing the header of a save game.
+	 * Can be called ahead of DoOperation, which will then continue from where this left off.
+	 */
+	virtual UE::Tasks::FTask Prepare() = 0;
 	virtual UE::Tasks::FTask DoOperation() = 0;
+
+	/** The size of the save game data before it's compressed (or after it's decompressed) */
+	virtual int64 GetUncompressedSize() const = 0;
+
+	/** Requests that the operation stops at its next phase boundary. Only saves can be cancelled. */
+	void Cancel() { bCancelled = true; }
+	bool IsCancelled() const { return bCancelled; }
+
+	/** The operation couldn't continue (i.e. the save game couldn't be read), so it stopped at its next phase boundary */
+	bool HasFailed() const { return bFailed; }
+
+	/**
+	 * The handle that progress is reported to, kept alive by the subsystem until the operation finishes.
+	 * Can be set while a prefetch is already reporting its phases from a worker thread.
+	 */
+	void SetOperation(USaveGameOperation* InOperation) { Operation = InOperation; }
+	USaveGameOperation* GetOperation() const { return Operation; }
+
+	/** The name of the slot that's being saved to, or loaded from */
+	const FString& GetSaveName() const { return SlotName; }
+
+	/**
+	 * Loads into the current world instead of travelling to the saved map (i.e. for benchmarking), any saved level
+	 * actors must already be in the current level. Must be set before DoOperation.
+	 */
+	void SetLoadInPlace(bool bInLoadInPlace) { bLoadInPlace = bInLoadInPlace; }
+	bool IsLoadInPlace() const { return bLoadInPlace; }
+
+	/** How long was spent in a phase, only complete once the operation has finished */
+	double GetPhaseSeconds(ESaveGamePhase Phase) const { return PhaseSeconds[static_cast<int32>(Phase)]; }
+
+protected:
+	void Fail() { bFailed = true; }
+
+	void SetPhase(ESaveGamePhase Phase, int32 TotalActors = 0)
+	{
+		TRACE_SAVEGAME_PHASE(Phase, IsLoading(), TotalActors);
+
+		EndPhase();
+		CurrentPhase = Phase;
+		PhaseStartTime = FPlatformTime::Seconds();
+
+		if (USaveGameOperation* CurrentOperation = Operation)
+		{
+			CurrentOperation->SetPhase(Phase, TotalActors);
+		}
+	}
+
+	/** Stops timing the current phase, i.e. when we're about to wait on something that isn't part of the next one */
+	void EndPhase()
+	{
+		if (CurrentPhase != ESaveGamePhase::Pending)
+		{
+			PhaseSeconds[static_cast<int32>(CurrentPhase)] += FPlatformTime::Seconds() - PhaseStartTime;
+			CurrentPhase = ESaveGamePhase::Pending;
+		}
+	}
+
+	void AddCompletedActor() const
+	{
+		if (USaveGameOperation* CurrentOperation = Operation)
+		{
+			CurrentOperation->AddCompletedActor();
+		}
+	}
+
+private:
+	const FString SlotName;
+	std::atomic<bool> bCancelled = false;
+	std::atomic<bool> bFailed = false;
+	bool bLoadInPlace = false;
+	std::atomic<USaveGameOperation*> Operation = nullptr;
+
+	/** Phases are only ever changed by one task at a time, as each task waits on the previous one */
+	ESaveGamePhase CurrentPhase = ESaveGamePhase::Pending;
+	double PhaseStartTime = 0.0;
+	double PhaseSeconds[static_cast<int32>(ESaveGamePhase::Cancelled) + 1] = {};
 };
 
 /**
  * The class that manages serializing the world.
  *
+ * The file starts with an uncompressed FSaveGameSlotHeader, followed by the archive, compressed in independent chunks
+ * (see FSaveGameCompressedChunks).
+ *
  * Archive data structured like so:
  * - Header
  *		- Map Name
  *		- Engine Versions
  * - Actors
  *		- Actor Name #1:
+ *			- Data Offset: Where "Data written by ISaveGameObject::OnSerialize" starts (binary only)
  *			- Class: If spawned
  *			- SpawnID: If implements ISaveGameSpawnActor
+ *			- Row: If the save has columns and its class is columnar, its row in them (instead of its SaveGame Properties)
  *			- SaveGame Properties
+ *			- Bulk Arrays: If its class has any SaveGame arrays of plain old data (see FSaveGameBulkArrays)
  *			- Data written by ISaveGameObject::OnSerialize
  *		- ...
+ * - Actor Index: Each actor's name and class (if spawned), so they can be listed without reading them (binary only)
  * - Destroyed Level Actors
  *		- Actor Name #1
  *		- ...
@@ -40,6 +149,8 @@ public:
  *			- ID
  *			- Version Number
  *		- ...
+ * - Columns: The SaveGame properties of columnar classes (see FSaveGameColumns)
+ * - Physics States: The velocities and sleep state of the actors' simulating primitives (see FSaveGamePhysicsStates)
  */
 template<bool bIsLoading>
 class TSaveGameSerializer final : public FSaveGameSerializer
@@ -47,17 +158,17 @@ class TSaveGameSerializer final : public FSaveGameSerializer
 	using TSaveGameMemoryArchive = typename TChooseClass<bIsLoading, FMemoryReader, FMemoryWriter>::Result;
 
 public:
-	TSaveGameSerializer(USaveGameSubsystem* InSaveGameSubsystem);
+	TSaveGameSerializer(USaveGameSubsystem* InSaveGameSubsystem, const FString& InSlotName);
 	virtual ~TSaveGameSerializer() override;
 
 	virtual bool IsLoading() const override { return bIsLoading; }
+	virtual UE::Tasks::FTask Prepare() override;
 	virtual UE::Tasks::FTask DoOperation() override;
+	virtual int64 GetUncompressedSize() const override { return Data.Num(); }
 
 private:
 	struct FActorInfo;
 
-	static FString GetSaveName();
-
 	void SerializeVersionOffset();
 
 	/** Serializes information about the archive, like Map Name, and position of versioning information */
@@ -65,25 +176,43 @@ private:
 
 	/**
 	 * Serializes all of the actors that the SaveGameSubsystem is keeping track of.
-	 * On load, it will also pre-spawn any actors and map any actors with Spawn IDs
+	 * On load, it will also pre-spawn any actors (or find them by Spawn ID, using the subsystem's index)
 	 * before running the actual serialization step.
 	 */
 	void SerializeActors();
 
-	void InitializeActor(int32 ActorIdx);
-	void SerializeActor(int32 ActorIdx);
+	/** When saving, sorts the actors into the order that's set in USaveGameSettings::ActorOrder */
+	void SortActors();
+
+	void InitializeActor(ISaveGameThreadQueue& ThreadQueue, int32 ActorIdx);
+	void SerializeActor(ISaveGameThreadQueue& ThreadQueue, int32 ActorIdx);
 
 	void MergeSaveData();
 
-	/** Serializes any destroyed level actors. On load, level actors will exist again, so this will re-destroy them */
+	/**
+	 * Serializes any destroyed level actors. On load, this is read before travelling to the map, so that
+	 * FilterDestroyedActors can remove them before they're initialized.
+	 */
 	void SerializeDestroyedActors();
 
+	/** On load, destroys the loaded level actors that were destroyed in the save, before they have been initialized */
+	void FilterDestroyedActors(UWorld* World);
+
+	/** On load, destroys any remaining destroyed level actors, and tracks them in the subsystem again */
+	void RestoreDestroyedActors();
+
 	/**
 	 * Serialized at the end of the archive, the versions are useful for marshaling old data.
 	 * These also contain the versions added by USaveGameFunctionLibrary::UseCustomVersion.
 	 */
 	void SerializeVersions();
 
+	/** Serialized after the versions, as the columns are only complete once every actor has been serialized */
+	void SerializeColumns();
+
+	/** Serialized after the columns. When saving, these are captured along with the actors. */
+	void SerializePhysicsStates();
+
 	USaveGameSubsystem* Subsystem;
 	TArray<uint8> Data;
 	TSaveGameMemoryArchive Archive;
@@ -94,10 +223,36 @@ private:
 	TArray<uint64> ActorOffsets;
 	TArray<TWeakObjectPtr<AActor>> SaveGameActors;
 	TArray<FActorInfo> ActorData;
-	TMap<FGuid, TWeakObjectPtr<AActor>> SpawnIDs;
+
+	/** The SaveGame properties of columnar classes, and when saving, each actor's row (or INDEX_NONE) */
+	FSaveGameColumns Columns;
+	TArray<int32> ColumnRows;
+
+	/** When loading, the transforms read by USaveGameFunctionLibrary::SerializeActorTransform */
+	FSaveGameTransformBatch TransformBatch;
+
+	FSaveGamePhysicsStates PhysicsStates;
+
+	/** Per-class measurements, only gathered when SaveGame.Profile is enabled */
+	FSaveGameProfiler Profiler;
+
+	/** When loading, the level's actors by name, built once the map has loaded */
+	FSaveGameLevelActorIndex LevelActors;
+
+	/** The slot's metadata, gathered on the game thread when saving, or read from the slot's header when loading */
+	FSaveGameSlotInfo SlotInfo;
+
+	/** When loading, the names of the level actors that were destroyed in the save */
+	TArray<FName> DestroyedActorNames;
+
+	/** The last task started by Prepare, only valid once it has been called */
+	UE::Tasks::FTask PrepareTask;
 
 	FString MapName;
 	uint64 ActorOffsetsOffset;
+	uint64 ActorIndexOffset;
 	uint64 VersionOffset;
 	uint64 ActorsOffset;
+	uint64 ColumnsOffset;
+	uint64 PhysicsStatesOffset;
 };
@@ -0,0 +1,177 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameSlotHeader.h"
+
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+#include "SaveGameSystem.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace SaveGameSlotHeader
+{
+	constexpr uint32 Magic = 0x48534753; // "SGSH"
+
+	/** Guards against reading garbage from a corrupt file */
+	constexpr int32 MaxHeaderSize = 64 * 1024;
+
+	/** The size of the magic and header size */
+	constexpr int32 PrefixSize = sizeof(uint32) + sizeof(int32);
+
+	enum class EVersion : int32
+	{
+		Initial = 1,
+
+		// The save game data after the header is compressed in independent chunks, rather than as one stream
+		CompressedChunks,
+
+		// -----<new versions can be added above this line>-------------------------------------------------
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	void SerializeInfo(FArchive& Ar, FSaveGameSlotInfo& Info)
+	{
+		Ar << Info.MapName;
+		Ar << Info.Timestamp;
+		Ar << Info.PlayTime;
+		Ar << Info.Version;
+		Ar << Info.EngineVersion;
+		Ar << Info.UserData;
+	}
+
+	/** Where FGenericSaveGameSystem stores its save games */
+	FString GetSlotFilePath(const FString& SlotName)
+	{
+		return FPaths::ProjectSavedDir() / TEXT("SaveGames") / SlotName + TEXT(".sav");
+	}
+}
+
+void FSaveGameSlotHeader::Write(FArchive& Ar, FSaveGameSlotInfo Info)
+{
+	using namespace SaveGameSlotHeader;
+
+	check(!Ar.IsLoading());
+
+	TArray<uint8> HeaderData;
+	FMemoryWriter HeaderArchive(HeaderData);
+
+	int32 Version = static_cast<int32>(EVersion::LatestVersion);
+	HeaderArchive << Version;
+	SerializeInfo(HeaderArchive, Info);
+
+	check(HeaderData.Num() <= MaxHeaderSize);
+
+	uint32 FileMagic = Magic;
+	int32 HeaderSize = HeaderData.Num();
+
+	Ar << FileMagic;
+	Ar << HeaderSize;
+	Ar.Serialize(HeaderData.GetData(), HeaderSize);
+}
+
+bool FSaveGameSlotHeader::Read(FArchive& Ar, FSaveGameSlotInfo& OutInfo, ESaveGameCompression* OutCompression)
+{
+	using namespace SaveGameSlotHeader;
+
+	check(Ar.IsLoading());
+
+	if (OutCompression)
+	{
+		*OutCompression = ESaveGameCompression::Stream;
+	}
+
+	const int64 StartOffset = Ar.Tell();
+
+	uint32 FileMagic = 0;
+	int32 HeaderSize = 0;
+
+	if (Ar.TotalSize() - StartOffset >= PrefixSize)
+	{
+		Ar << FileMagic;
+		Ar << HeaderSize;
+	}
+
+	// Older saves start with the compressed data, so leave them where they were
+	if (FileMagic != Magic || HeaderSize < 0 || HeaderSize > MaxHeaderSize)
+	{
+		Ar.Seek(StartOffset);
+		return false;
+	}
+
+	const int64 DataOffset = Ar.Tell() + HeaderSize;
+
+	int32 Version = 0;
+	Ar << Version;
+
+	if (OutCompression && Version >= static_cast<int32>(EVersion::CompressedChunks))
+	{
+		*OutCompression = ESaveGameCompression::Chunks;
+	}
+
+	// We can still skip a header from a newer version, we just can't read it
+	const bool bCanRead = Version <= static_cast<int32>(EVersion::LatestVersion);
+	if (bCanRead)
+	{
+		SerializeInfo(Ar, OutInfo);
+	}
+
+	const bool bSuccess = bCanRead && !Ar.IsError() && Ar.Tell() <= DataOffset;
+
+	Ar.Seek(DataOffset);
+	return bSuccess;
+}
+
+bool FSaveGameSlotHeader::ReadSlot(ISaveGameSystem& SaveSystem, const FString& SlotName, FSaveGameSlotInfo& OutInfo)
+{
+	using namespace SaveGameSlotHeader;
+
+	TArray<uint8> HeaderData;
+	bool bFoundFile = false;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (TUniquePtr<IFileHandle> FileHandle = TUniquePtr<IFileHandle>(PlatformFile.OpenRead(*GetSlotFilePath(SlotName))))
+	{
+		bFoundFile = true;
+
+		// Read the prefix first, so that we know how much more of the header we need
+		HeaderData.SetNumUninitialized(PrefixSize);
+		if (!FileHandle->Read(HeaderData.GetData(), PrefixSize))
+		{
+			return false;
+		}
+
+		uint32 FileMagic;
+		int32 HeaderSize;
+
+		FMemoryReader PrefixArchive(HeaderData);
+		PrefixArchive << FileMagic;
+		PrefixArchive << HeaderSize;
+
+		if (FileMagic != Magic || HeaderSize < 0 || HeaderSize > MaxHeaderSize)
+		{
+			return false;
+		}
+
+		HeaderData.SetNumUninitialized(PrefixSize + HeaderSize);
+		if (!FileHandle->Read(HeaderData.GetData() + PrefixSize, HeaderSize))
+		{
+			return false;
+		}
+	}
+
+	// The platform stores save games somewhere else, so we'll have to load the whole slot
+	if (!bFoundFile && !SaveSystem.LoadGame(false, *SlotName, 0, HeaderData))
+	{
+		return false;
+	}
+
+	FMemoryReader HeaderArchive(HeaderData);
+	if (!Read(HeaderArchive, OutInfo))
+	{
+		return false;
+	}
+
+	OutInfo.SlotName = SlotName;
+	return true;
+}
@@ -0,0 +1,48 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "SaveGameSlotInfo.h"
+
+class ISaveGameSystem;
+
+/** How the save game data that follows the slot's header is compressed */
+enum class ESaveGameCompression : uint8
+{
+	/** A single FArchive::SerializeCompressed stream, which can only be decompressed as a whole */
+	Stream,
+	/** Independently decompressible chunks (see FSaveGameCompressedChunks) */
+	Chunks,
+};
+
+/**
+ * Reads and writes the uncompressed header at the start of a save game file.
+ *
+ * File layout:
+ * - Magic
+ * - Header Size
+ * - Header (FSaveGameSlotInfo, prefixed by the header's version)
+ * - Compressed save game data, in chunks since the header's CompressedChunks version
+ *
+ * Saves from before the header was added start directly with the compressed data.
+ */
+struct FSaveGameSlotHeader
+{
+	/** Writes the header, leaving the archive where the compressed data should start (which should be compressed in chunks) */
+	static void Write(FArchive& Ar, FSaveGameSlotInfo Info);
+
+	/**
+	 * Reads the header, always leaving the archive at the start of the compressed data.
+	 *
+	 * @param OutCompression How the data after the header is compressed, even if the header itself couldn't be read
+	 * @return false if there's no header (i.e. an older save), or it couldn't be read
+	 */
+	static bool Read(FArchive& Ar, FSaveGameSlotInfo& OutInfo, ESaveGameCompression* OutCompression = nullptr);
+
+	/**
+	 * Reads only the header of a slot. Where the save game is a file on disk, only the header's bytes are read,
+	 * otherwise the slot is loaded through the save game system (but still not decompressed).
+	 * Safe to call from any thread.
+	 */
+	static bool ReadSlot(ISaveGameSystem& SaveSystem, const FString& SlotName, FSaveGameSlotInfo& OutInfo);
+};
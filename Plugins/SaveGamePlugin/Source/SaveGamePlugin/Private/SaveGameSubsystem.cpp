@@ -2,11 +2,18 @@
 
 #include "SaveGameSubsystem.h"
 
+#include "SaveGameClassTraits.h"
 #include "SaveGameFunctionLibrary.h"
 #include "SaveGameObject.h"
 #include "SaveGameSerializer.h"
+#include "SaveGameSettings.h"
+#include "SaveGameSlotHeader.h"
+#include "SaveGameVersion.h"
 
 #include "EngineUtils.h"
+#include "PlatformFeatures.h"
+#include "SaveGameSystem.h"
+#include "Async/ParallelFor.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogSaveGameSubsystem, Log, All);
 
@@ -18,6 +25,11 @@ void USaveGameSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 	FWorldDelegates::OnWorldInitializedActors.AddUObject(this, &ThisClass::OnActorsInitialized);
 	FWorldDelegates::OnWorldCleanup.AddUObject(this, &ThisClass::OnWorldCleanup);
 
+	// Classes may have been recompiled since we last ran, so don't trust any previously cached traits
+	FSaveGameClassTraits::Reset();
+
+	LoadedPlayTimeStart = FPlatformTime::Seconds();
+
 	// This example doesn't handle streaming levels, but if we did, we'd use a combination of
 	// FWorldDelegates::LevelAddedToWorld and FWorldDelegates::PreLevelRemovedFromWorld
 	// In these, we'd store the current state of actors within that level
@@ -33,50 +45,230 @@ void USaveGameSubsystem::Deinitialize()
 
 	FWorldDelegates::LevelAddedToWorld.RemoveAll(this);
 	FWorldDelegates::PreLevelRemovedFromWorld.RemoveAll(this);
+
+	ClearPrefetched();
+}
+
+void USaveGameSubsystem::Save(const FString& SlotName)
+{
+	SaveAsync(SlotName);
 }
 
-void USaveGameSubsystem::Save()
+void USaveGameSubsystem::Load(const FString& SlotName)
+{
+	LoadAsync(SlotName);
+}
+
+USaveGameOperation* USaveGameSubsystem::SaveAsync(const FString& SlotName)
 {
 	constexpr TCHAR RegionName[] = TEXT("SaveGame[Save]");
+
+	TSharedPtr<TSaveGameSerializer<false>> Serializer = MakeShared<TSaveGameSerializer<false>>(this, SlotName);
+
+	{
+		FScopeLock Lock(&SaveRequestsSection);
+
+		// A save that hasn't started yet will capture the world as it is when it does, so it can absorb this request
+		if (const TSharedPtr<FSaveGameSerializer>* PendingSave = PendingSaves.Find(SlotName); PendingSave && !(*PendingSave)->IsCancelled())
+		{
+			UE_LOG(LogSaveGameSubsystem, Log, TEXT("%s: Coalesced into pending save of %s"), RegionName, *SlotName);
+			return (*PendingSave)->GetOperation();
+		}
+
+		// We're about to save a newer state, any save to this slot that's in flight is redundant
+		if (const TSharedPtr<FSaveGameSerializer>* ActiveSave = ActiveSaves.Find(SlotName))
+		{
+			(*ActiveSave)->Cancel();
+		}
+
+		PendingSaves.Add(SlotName, Serializer);
+	}
+
+	USaveGameOperation* Operation = CreateOperation(Serializer.ToSharedRef());
+
+	// Anything we've prefetched for this slot is about to be out of date
+	ReleasePrefetched(TakePrefetched(SlotName));
+
 	UE_LOG(LogSaveGameSubsystem, Log, TEXT("%s: Begin"), RegionName);
 	TRACE_BEGIN_REGION(RegionName);
 
-	TSharedPtr<TSaveGameSerializer<false>> Serializer = MakeShared<TSaveGameSerializer<false>>(this);
-
 	SaveGamePipe.Launch(UE_SOURCE_LOCATION, [this, Serializer]
 	{
+		{
+			FScopeLock Lock(&SaveRequestsSection);
+
+			// We've started, so any later save requests will need their own save.
+			// A load may have since cancelled us and let a newer save to this slot become the pending one.
+			const FString& SaveName = Serializer->GetSaveName();
+			if (const TSharedPtr<FSaveGameSerializer>* PendingSave = PendingSaves.Find(SaveName); PendingSave && PendingSave->Get() == Serializer.Get())
+			{
+				PendingSaves.Remove(SaveName);
+			}
+
+			ActiveSaves.Add(SaveName, Serializer);
+		}
+
 		FTask Previous = Serializer->DoOperation();
 
 		// This will also keep the Serializer alive until we're complete
-		AddNested(Launch(UE_SOURCE_LOCATION, [Serializer] () mutable
+		AddNested(Launch(UE_SOURCE_LOCATION, [this, Serializer] () mutable
 		{
+			{
+				FScopeLock Lock(&SaveRequestsSection);
+
+				const FString& SaveName = Serializer->GetSaveName();
+				if (const TSharedPtr<FSaveGameSerializer>* ActiveSave = ActiveSaves.Find(SaveName); ActiveSave && ActiveSave->Get() == Serializer.Get())
+				{
+					ActiveSaves.Remove(SaveName);
+				}
+			}
+
+			const bool bCancelled = Serializer->IsCancelled();
+			Serializer->GetOperation()->Finish(!bCancelled);
 			Serializer.Reset();
+
 			TRACE_END_REGION(RegionName);
-			UE_LOG(LogSaveGameSubsystem, Log, TEXT("%s: End"), RegionName);
+			UE_LOG(LogSaveGameSubsystem, Log, TEXT("%s: %s"), RegionName, bCancelled ? TEXT("Cancelled") : TEXT("End"));
 		}, Previous));
 	});
+
+	return Operation;
 }
 
-void USaveGameSubsystem::Load()
+USaveGameOperation* USaveGameSubsystem::LoadAsync(const FString& SlotName)
 {
 	constexpr TCHAR RegionName[] = TEXT("SaveGame[Load]");
 	UE_LOG(LogSaveGameSubsystem, Log, TEXT("%s: Begin"), RegionName);
 	TRACE_BEGIN_REGION(RegionName);
 
-	TSharedPtr<TSaveGameSerializer<true>> Serializer = MakeShared<TSaveGameSerializer<true>>(this);
+	{
+		FScopeLock Lock(&SaveRequestsSection);
+
+		// The world is about to be replaced, so there's no point finishing any saves (to any slot) before we load
+		for (const TPair<FString, TSharedPtr<FSaveGameSerializer>>& PendingSave : PendingSaves)
+		{
+			PendingSave.Value->Cancel();
+		}
 
-	SaveGamePipe.Launch(UE_SOURCE_LOCATION, [this, Serializer]
+		// Saves requested after this load shouldn't be absorbed by the cancelled saves, so they queue behind the load
+		PendingSaves.Reset();
+
+		for (const TPair<FString, TSharedPtr<FSaveGameSerializer>>& ActiveSave : ActiveSaves)
+		{
+			ActiveSave.Value->Cancel();
+		}
+	}
+
+	// If we've prefetched this save, it may have already been read and decoded
+	TSharedPtr<FSaveGameSerializer> Serializer = TakePrefetched(SlotName);
+	if (Serializer.IsValid())
+	{
+		UE_LOG(LogSaveGameSubsystem, Log, TEXT("%s: Using prefetched save"), RegionName);
+	}
+	else
+	{
+		Serializer = MakeShared<TSaveGameSerializer<true>>(this, SlotName);
+	}
+
+	USaveGameOperation* Operation = CreateOperation(Serializer.ToSharedRef());
+
+	SaveGamePipe.Launch(UE_SOURCE_LOCATION, [Serializer]
 	{
 		FTask Previous = Serializer->DoOperation();
 
 		// This will also keep the Serializer alive until we're complete
 		AddNested(Launch(UE_SOURCE_LOCATION, [Serializer] () mutable
 		{
-			Serializer.Reset();
+			const bool bFailed = Serializer->HasFailed();
+			Serializer->GetOperation()->Finish(!bFailed);
+
 			TRACE_END_REGION(RegionName);
-			UE_LOG(LogSaveGameSubsystem, Log, TEXT("%s: End"), RegionName);
+			if (bFailed)
+			{
+				UE_LOG(LogSaveGameSubsystem, Error, TEXT("%s: Failed to read save game: %s"), RegionName, *Serializer->GetSaveName());
+			}
+			else
+			{
+				UE_LOG(LogSaveGameSubsystem, Log, TEXT("%s: End"), RegionName);
+			}
+
+			Serializer.Reset();
 		}, Previous));
 	});
+
+	return Operation;
+}
+
+void USaveGameSubsystem::Prefetch(const FString& SlotName)
+{
+	check(IsInGameThread());
+
+	{
+		FScopeLock Lock(&SaveRequestsSection);
+
+		if (!PendingSaves.IsEmpty() || !ActiveSaves.IsEmpty())
+		{
+			return;
+		}
+	}
+
+	// If we've already started on this save, just mark it as the most recently used
+	TSharedPtr<FSaveGameSerializer> Serializer = TakePrefetched(SlotName);
+	if (!Serializer.IsValid())
+	{
+		Serializer = MakeShared<TSaveGameSerializer<true>>(this, SlotName);
+		Serializer->Prepare();
+	}
+
+	PrefetchedLoads.Emplace(SlotName, MoveTemp(Serializer));
+
+	const int32 MaxPrefetchedSaves = FMath::Max(GetDefault<USaveGameSettings>()->MaxPrefetchedSaves, 0);
+	while (PrefetchedLoads.Num() > MaxPrefetchedSaves)
+	{
+		ReleasePrefetched(MoveTemp(PrefetchedLoads[0].Value));
+		PrefetchedLoads.RemoveAt(0);
+	}
+}
+
+void USaveGameSubsystem::ClearPrefetched()
+{
+	check(IsInGameThread());
+
+	for (TPair<FString, TSharedPtr<FSaveGameSerializer>>& PrefetchedLoad : PrefetchedLoads)
+	{
+		ReleasePrefetched(MoveTemp(PrefetchedLoad.Value));
+	}
+
+	PrefetchedLoads.Reset();
+}
+
+TSharedPtr<FSaveGameSerializer> USaveGameSubsystem::TakePrefetched(const FString& SaveName)
+{
+	check(IsInGameThread());
+
+	const int32 Index = PrefetchedLoads.IndexOfByPredicate([&SaveName](const TPair<FString, TSharedPtr<FSaveGameSerializer>>& PrefetchedLoad)
+	{
+		return PrefetchedLoad.Key == SaveName;
+	});
+
+	if (Index == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	TSharedPtr<FSaveGameSerializer> Serializer = MoveTemp(PrefetchedLoads[Index].Value);
+	PrefetchedLoads.RemoveAt(Index);
+	return Serializer;
+}
+
+void USaveGameSubsystem::ReleasePrefetched(TSharedPtr<FSaveGameSerializer>&& Serializer)
+{
+	if (Serializer.IsValid())
+	{
+		// The prepare tasks only hold onto the serializer by pointer
+		const FTask PrepareTask = Serializer->Prepare();
+		Launch(UE_SOURCE_LOCATION, [Serializer = MoveTemp(Serializer)]{}, PrepareTask);
+	}
 }
 
 bool USaveGameSubsystem::IsLoadingSaveGame() const
@@ -84,6 +276,94 @@ bool USaveGameSubsystem::IsLoadingSaveGame() const
 	return SaveGamePipe.HasWork();
 }
 
+TArray<FSaveGameSlotInfo> USaveGameSubsystem::ListSlots() const
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_ListSlots);
+
+	ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+
+	TArray<FString> SlotNames;
+	if (!SaveSystem || !SaveSystem->GetSaveGameNames(SlotNames, 0))
+	{
+		return {};
+	}
+
+	// Skip the debug json that's written alongside each save
+	SlotNames.RemoveAll([](const FString& SlotName)
+	{
+		return SlotName.EndsWith(TEXT(".json"));
+	});
+
+	TArray<FSaveGameSlotInfo> Slots;
+	Slots.SetNum(SlotNames.Num());
+
+	TArray<bool> ReadSlots;
+	ReadSlots.SetNumZeroed(SlotNames.Num());
+
+	ParallelFor(SlotNames.Num(), [&](int32 SlotIdx)
+	{
+		ReadSlots[SlotIdx] = FSaveGameSlotHeader::ReadSlot(*SaveSystem, SlotNames[SlotIdx], Slots[SlotIdx]);
+	});
+
+	// Slots without metadata (i.e. from before it was added) are still listed, we just don't know anything about them
+	for (int32 SlotIdx = 0; SlotIdx < Slots.Num(); ++SlotIdx)
+	{
+		if (!ReadSlots[SlotIdx])
+		{
+			Slots[SlotIdx] = FSaveGameSlotInfo();
+			Slots[SlotIdx].SlotName = SlotNames[SlotIdx];
+		}
+	}
+
+	Slots.Sort([](const FSaveGameSlotInfo& A, const FSaveGameSlotInfo& B)
+	{
+		return A.Timestamp > B.Timestamp;
+	});
+
+	return Slots;
+}
+
+double USaveGameSubsystem::GetPlayTime() const
+{
+	return LoadedPlayTime + (FPlatformTime::Seconds() - LoadedPlayTimeStart);
+}
+
+FSaveGameSlotInfo USaveGameSubsystem::GatherSlotInfo() const
+{
+	check(IsInGameThread());
+
+	FSaveGameSlotInfo SlotInfo;
+	SlotInfo.Timestamp = FDateTime::UtcNow();
+	SlotInfo.PlayTime = GetPlayTime();
+	SlotInfo.Version = FSaveGameVersion::LatestVersion;
+	SlotInfo.EngineVersion = FEngineVersion::Current().ToString();
+	SlotInfo.UserData = SlotUserData;
+	return SlotInfo;
+}
+
+void USaveGameSubsystem::RestoreSlotInfo(const FSaveGameSlotInfo& SlotInfo)
+{
+	check(IsInGameThread());
+
+	LoadedPlayTime = SlotInfo.PlayTime;
+	LoadedPlayTimeStart = FPlatformTime::Seconds();
+	SlotUserData = SlotInfo.UserData;
+}
+
+USaveGameOperation* USaveGameSubsystem::CreateOperation(const TSharedRef<FSaveGameSerializer>& Serializer)
+{
+	check(IsInGameThread());
+
+	USaveGameOperation* Operation = NewObject<USaveGameOperation>(this);
+	Operation->Initialize(Serializer, Serializer->IsLoading());
+	Serializer->SetOperation(Operation);
+
+	// Keep the operation alive while it's in flight, it will remove itself when finished
+	ActiveOperations.Add(Operation);
+
+	return Operation;
+}
+
 void USaveGameSubsystem::OnWorldInitialized(UWorld* World, const UWorld::InitializationValues)
 {
 	if (!IsValid(World) || GetWorld() != World)
@@ -92,6 +372,7 @@ void USaveGameSubsystem::OnWorldInitialized(UWorld* World, const UWorld::Initial
 	}
 
 	World->AddOnActorPreSpawnInitialization(FOnActorSpawned::FDelegate::CreateUObject(this, &ThisClass::OnActorPreSpawn));
+	World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &ThisClass::OnActorSpawned));
 	World->AddOnActorDestroyedHandler(FOnActorDestroyed::FDelegate::CreateUObject(this, &ThisClass::OnActorDestroyed));
 }
 
@@ -105,9 +386,10 @@ void USaveGameSubsystem::OnActorsInitialized(const FActorsInitializedParams& Par
 	for (TActorIterator<AActor> It(Params.World); It; ++It)
 	{
 		AActor* Actor = *It;
-		if (IsValid(Actor) && Actor->Implements<USaveGameObject>())
+		if (IsValid(Actor) && FSaveGameClassTraits::Get(Actor).bIsSaveGameObject)
 		{
 			SaveGameActors.Add(Actor);
+			AddSpawnID(Actor);
 		}
 	}
 }
@@ -120,23 +402,64 @@ void USaveGameSubsystem::OnWorldCleanup(UWorld* World, bool, bool)
 	}
 
 	SaveGameActors.Reset();
+	SpawnIDs.Reset();
 	DestroyedLevelActors.Reset();
 }
 
 void USaveGameSubsystem::OnActorPreSpawn(AActor* Actor)
 {
-	if (IsValid(Actor) && Actor->Implements<USaveGameObject>())
+	if (IsValid(Actor) && FSaveGameClassTraits::Get(Actor).bIsSaveGameObject)
 	{
 		SaveGameActors.Add(Actor);
 	}
 }
 
+void USaveGameSubsystem::OnActorSpawned(AActor* Actor)
+{
+	// By now the actor has been constructed and begun play, so it should know its SpawnID
+	if (IsValid(Actor) && SaveGameActors.Contains(Actor))
+	{
+		AddSpawnID(Actor);
+	}
+}
+
 void USaveGameSubsystem::OnActorDestroyed(AActor* Actor)
 {
-	SaveGameActors.Remove(Actor);
+	if (SaveGameActors.Remove(Actor))
+	{
+		RemoveSpawnID(Actor);
+	}
 
 	if (USaveGameFunctionLibrary::WasObjectLoaded(Actor))
 	{
 		DestroyedLevelActors.Add(Actor);
 	}
 }
+
+void USaveGameSubsystem::AddSpawnID(AActor* Actor)
+{
+	if (FSaveGameClassTraits::Get(Actor).bIsSpawnActor)
+	{
+		const FGuid SpawnID = ISaveGameSpawnActor::Execute_GetSpawnID(Actor);
+
+		if (SpawnID.IsValid())
+		{
+			SpawnIDs.Add(SpawnID, Actor);
+		}
+	}
+}
+
+void USaveGameSubsystem::RemoveSpawnID(AActor* Actor)
+{
+	if (FSaveGameClassTraits::Get(Actor).bIsSpawnActor)
+	{
+		const FGuid SpawnID = ISaveGameSpawnActor::Execute_GetSpawnID(Actor);
+		const TWeakObjectPtr<AActor>* MappedActor = SpawnIDs.Find(SpawnID);
+
+		// Only remove if we're mapped, another actor may have since taken this SpawnID
+		if (MappedActor && MappedActor->Get(true) == Actor)
+		{
+			SpawnIDs.Remove(SpawnID);
+		}
+	}
+}
@@ -2,12 +2,53 @@
 
 #include "SaveGameThreading.h"
 
+#include "atomic_queue/atomic_queue.h"
+
+#include <atomic>
+
+DEFINE_LOG_CATEGORY_STATIC(LogSaveGameThreading, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("SaveGame"), STATGROUP_SaveGame, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Thread Queue: Tasks"), STAT_SaveGame_ThreadQueueTasks, STATGROUP_SaveGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Thread Queue: Spin Wakes"), STAT_SaveGame_ThreadQueueSpinWakes, STATGROUP_SaveGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Thread Queue: Yield Wakes"), STAT_SaveGame_ThreadQueueYieldWakes, STATGROUP_SaveGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Thread Queue: Blocking Wakes"), STAT_SaveGame_ThreadQueueBlockWakes, STATGROUP_SaveGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Thread Queue: Timeouts"), STAT_SaveGame_ThreadQueueTimeouts, STATGROUP_SaveGame);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Thread Queue: Avg Inter-Arrival (us)"), STAT_SaveGame_ThreadQueueInterArrival, STATGROUP_SaveGame);
+
+/**
+ * Bounds on the tasks that can be queued before producers have to spill over into the (allocating) overflow queue.
+ * Each slot is an inline FSaveGameTask, so the ring is sized to the operation rather than always to the maximum.
+ */
+constexpr uint32 SaveGameThreadQueueMinCapacity = 64;
+constexpr uint32 SaveGameThreadQueueMaxCapacity = 16384;
+
+/** Spin for this multiple of the average inter-arrival time before yielding */
+constexpr double SaveGameThreadQueueSpinFactor = 2.0;
+
+/** Never spin longer than this, past this point tasks are arriving slowly enough to sleep between them */
+constexpr double SaveGameThreadQueueMaxSpinSeconds = 50e-6;
+
+/** Number of times to yield our time slice before blocking on the event */
+constexpr int32 SaveGameThreadQueueNumYields = 4;
+
+/** Weight of each new inter-arrival sample in the moving average */
+constexpr double SaveGameThreadQueueSampleWeight = 0.125;
+
+/** Inter-arrival time to assume before the first sample, so that the first waits spin briefly rather than block */
+constexpr double SaveGameThreadQueueInitialInterArrivalSeconds = 5e-6;
+
 class FSaveGameThreadQueue final : public ISaveGameThreadQueue
 {
 public:
-	FSaveGameThreadQueue()
+	explicit FSaveGameThreadQueue(uint32 Capacity)
 		: ThreadId(FPlatformTLS::GetCurrentThreadId())
-		, Event(FPlatformProcess::GetSynchEventFromPool(true))
+		, WorkQueue(FMath::Clamp(Capacity, SaveGameThreadQueueMinCapacity, SaveGameThreadQueueMaxCapacity))
+		, Event(FPlatformProcess::GetSynchEventFromPool(false))
+		, bIsWaiting(false)
+		, MaxSpinCycles(SaveGameThreadQueueMaxSpinSeconds / FPlatformTime::GetSecondsPerCycle64())
+		, AverageInterArrivalCycles(SaveGameThreadQueueInitialInterArrivalSeconds / FPlatformTime::GetSecondsPerCycle64())
+		, LastArrivalCycles(0)
 	{}
 
 	virtual ~FSaveGameThreadQueue() override
@@ -15,72 +56,252 @@ public:
 		check(ThreadId == FPlatformTLS::GetCurrentThreadId());
 		check(IsComplete());
 
+		UE_LOG(LogSaveGameThreading, Verbose, TEXT("Thread Queue: %u tasks, %u spin wakes, %u yield wakes, %u blocking wakes, %u timeouts, %.2fus average inter-arrival"),
+			Stats.NumTasks, Stats.NumSpinWakes, Stats.NumYieldWakes, Stats.NumBlockWakes, Stats.NumTimeouts,
+			AverageInterArrivalCycles * FPlatformTime::GetSecondsPerCycle64() * 1e6);
+
 		FPlatformProcess::ReturnSynchEventToPool(Event);
 		Event = nullptr;
 	}
 
-	virtual void AddTask(TFunction<void()>&& Task) override
+	virtual void AddTask(FTaskFunction&& Task) override
 	{
-		WorkQueue.Push(new FTaskFunction(Task));
-		Event->Trigger();
+		if (!WorkQueue.try_push(MoveTemp(Task)))
+		{
+			// The ring is full, rather than blocking the worker, spill onto the heap
+			OverflowQueue.Push(new FTaskFunction(MoveTemp(Task)));
+		}
+
+		// Only signal the event if the game thread has gone to sleep, rather than once per task
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (bIsWaiting.load(std::memory_order_acquire) && bIsWaiting.exchange(false, std::memory_order_acq_rel))
+		{
+			Event->Trigger();
+		}
 	}
 
 	bool ProcessThread(int64 WaitCycles)
 	{
 		check(ThreadId == FPlatformTLS::GetCurrentThreadId());
 		bool bDidWork = false;
-		bool bTriggered;
 
 		do
 		{
+			bDidWork |= Drain();
+		} while (WaitForWork(WaitCycles) || !IsComplete());
+
+		return bDidWork;
+	}
+
+	const FSaveGameThreadQueueStats& GetStats() const { return Stats; }
+
+	bool IsComplete() const { return WorkQueue.was_empty() && OverflowQueue.IsEmpty(); }
+
+private:
+	enum class EWakeType : uint8
+	{
+		Spin,
+		Yield,
+		Block,
+		Timeout,
+	};
+
+	bool Drain()
+	{
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_ProcessThreadQueue);
+		uint32 NumTasks = 0;
+
+		FTaskFunction Function;
+		while (WorkQueue.try_pop(Function))
+		{
+			Function();
+			Function.Reset();
+			++NumTasks;
+		}
+
+		while (FTaskFunction* OverflowFunction = OverflowQueue.Pop())
+		{
+			(*OverflowFunction)();
+			delete OverflowFunction;
+			++NumTasks;
+		}
+
+		Stats.NumTasks += NumTasks;
+		INC_DWORD_STAT_BY(STAT_SaveGame_ThreadQueueTasks, NumTasks);
+
+		if (NumTasks > 0)
+		{
+			OnArrivals(NumTasks);
+		}
+
+		return NumTasks > 0;
+	}
+
+	/**
+	 * Samples how quickly tasks are arriving: the time since the previous drain that found tasks, spread over the
+	 * tasks found by this one. Gaps that include a timeout aren't sampled, as the workers may have simply finished.
+	 */
+	void OnArrivals(uint32 NumTasks)
+	{
+		const uint64 NowCycles = FPlatformTime::Cycles64();
+
+		if (LastArrivalCycles != 0)
+		{
+			const double Sample = static_cast<double>(NowCycles - LastArrivalCycles) / NumTasks;
+			AverageInterArrivalCycles += (Sample - AverageInterArrivalCycles) * SaveGameThreadQueueSampleWeight;
+
+			Stats.AverageInterArrivalSeconds = AverageInterArrivalCycles * FPlatformTime::GetSecondsPerCycle64();
+			SET_FLOAT_STAT(STAT_SaveGame_ThreadQueueInterArrival, Stats.AverageInterArrivalSeconds * 1e6);
+		}
+
+		LastArrivalCycles = NowCycles;
+	}
+
+	/**
+	 * Waits for the next task to arrive. Spins while tasks are expected soon (based on how quickly they've been
+	 * arriving), then yields, and finally blocks on the event until woken or timed out.
+	 * @return true if there's work to do
+	 */
+	bool WaitForWork(int64 WaitCycles)
+	{
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_WaitThreadQueue);
+
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		const uint64 SpinCycles = FMath::Min<uint64>(AverageInterArrivalCycles * SaveGameThreadQueueSpinFactor, MaxSpinCycles);
+
+		// If tasks are arriving faster than a context switch, spinning is our cheapest option
+		while (FPlatformTime::Cycles64() - StartCycles < SpinCycles)
+		{
+			if (!IsComplete())
 			{
-				QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_ProcessThreadQueue);
+				OnWake(EWakeType::Spin);
+				return true;
+			}
+
+			FPlatformProcess::YieldCycles(100);
+		}
 
-				while (const FTaskFunction* Function = WorkQueue.Pop())
+		// Only bother yielding when we're expecting tasks to turn up reasonably quickly
+		if (SpinCycles > 0)
+		{
+			for (int32 YieldIdx = 0; YieldIdx < SaveGameThreadQueueNumYields; ++YieldIdx)
+			{
+				FPlatformProcess::Yield();
+
+				if (!IsComplete())
 				{
-					(*Function)();
-					delete Function;
-					bDidWork = true;
+					OnWake(EWakeType::Yield);
+					return true;
 				}
 			}
+		}
 
-			QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_WaitThreadQueue);
-			Event->Reset();
-			bTriggered = Event->Wait(FTimespan(WaitCycles));
-		} while (bTriggered || !IsComplete());
+		// Let producers know that they'll need to wake us, then check again in case we missed a task
+		bIsWaiting.store(true, std::memory_order_seq_cst);
 
-		return bDidWork;
+		if (!IsComplete())
+		{
+			bIsWaiting.store(false, std::memory_order_relaxed);
+			OnWake(EWakeType::Block);
+			return true;
+		}
+
+		const bool bTriggered = Event->Wait(FTimespan(WaitCycles));
+		bIsWaiting.store(false, std::memory_order_relaxed);
+
+		OnWake(bTriggered ? EWakeType::Block : EWakeType::Timeout);
+		return bTriggered;
 	}
 
-	bool IsComplete() const { return WorkQueue.IsEmpty(); }
+	void OnWake(EWakeType WakeType)
+	{
+		switch (WakeType)
+		{
+		case EWakeType::Spin:
+			++Stats.NumSpinWakes;
+			INC_DWORD_STAT(STAT_SaveGame_ThreadQueueSpinWakes);
+			break;
+		case EWakeType::Yield:
+			++Stats.NumYieldWakes;
+			INC_DWORD_STAT(STAT_SaveGame_ThreadQueueYieldWakes);
+			break;
+		case EWakeType::Block:
+			++Stats.NumBlockWakes;
+			INC_DWORD_STAT(STAT_SaveGame_ThreadQueueBlockWakes);
+			break;
+		case EWakeType::Timeout:
+			++Stats.NumTimeouts;
+			INC_DWORD_STAT(STAT_SaveGame_ThreadQueueTimeouts);
+
+			// The next tasks (if any) aren't part of the same stream of arrivals
+			LastArrivalCycles = 0;
+			break;
+		}
+	}
 
-private:
 	const uint32 ThreadId;
-	TLockFreePointerListFIFO<FTaskFunction, PLATFORM_CACHE_LINE_SIZE> WorkQueue;
+
+	/** Multi-producer (workers), single consumer (game thread) ring of inline tasks */
+	atomic_queue::AtomicQueueB2<FTaskFunction> WorkQueue;
+	TLockFreePointerListFIFO<FTaskFunction, PLATFORM_CACHE_LINE_SIZE> OverflowQueue;
+
 	FEvent* Event;
+	std::atomic<bool> bIsWaiting;
+
+	const uint64 MaxSpinCycles;
+	double AverageInterArrivalCycles;
+	uint64 LastArrivalCycles;
+	FSaveGameThreadQueueStats Stats;
 };
 
-static TSharedPtr<FSaveGameThreadQueue> GSaveGameThreadQueue;
+static thread_local ISaveGameThreadQueue* GCurrentSaveGameThreadQueue = nullptr;
 
 ISaveGameThreadQueue& ISaveGameThreadQueue::Get()
 {
-	checkf(GSaveGameThreadQueue.IsValid(), TEXT("Use FSaveGameThreadScope to set up a Thread Queue!"));
-	return *GSaveGameThreadQueue;
+	checkf(GCurrentSaveGameThreadQueue, TEXT("Use FSaveGameThreadScope to set up a Thread Queue!"));
+	return *GCurrentSaveGameThreadQueue;
+}
+
+ISaveGameThreadQueue* ISaveGameThreadQueue::TryGet()
+{
+	return GCurrentSaveGameThreadQueue;
+}
+
+FSaveGameThreadQueueContext::FSaveGameThreadQueueContext(ISaveGameThreadQueue& Queue)
+	: PreviousQueue(GCurrentSaveGameThreadQueue)
+{
+	GCurrentSaveGameThreadQueue = &Queue;
 }
 
-FSaveGameTheadScope::FSaveGameTheadScope()
+FSaveGameThreadQueueContext::~FSaveGameThreadQueueContext()
+{
+	GCurrentSaveGameThreadQueue = PreviousQueue;
+}
+
+FSaveGameTheadScope::FSaveGameTheadScope(uint32 Capacity)
+	: Queue(MakeUnique<FSaveGameThreadQueue>(Capacity))
+	, Context(MakeUnique<FSaveGameThreadQueueContext>(*Queue))
 {
-	check(!GSaveGameThreadQueue.IsValid());
-	GSaveGameThreadQueue = MakeShared<FSaveGameThreadQueue>();
 }
 
 FSaveGameTheadScope::~FSaveGameTheadScope()
 {
-	check(GSaveGameThreadQueue.IsValid());
-	GSaveGameThreadQueue.Reset();
+	// Restore the previous context before the queue is destroyed
+	Context.Reset();
+	Queue.Reset();
+}
+
+ISaveGameThreadQueue& FSaveGameTheadScope::GetQueue() const
+{
+	return *Queue;
 }
 
 bool FSaveGameTheadScope::ProcessThread(int64 WaitCycles) const
 {
-	return GSaveGameThreadQueue->ProcessThread(WaitCycles);
+	return Queue->ProcessThread(WaitCycles);
+}
+
+const FSaveGameThreadQueueStats& FSaveGameTheadScope::GetStats() const
+{
+	return Queue->GetStats();
 }
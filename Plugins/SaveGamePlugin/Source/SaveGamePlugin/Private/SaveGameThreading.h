@@ -2,24 +2,192 @@
 
 #pragma once
 
-#include "Templates/FunctionFwd.h"
+#include "CoreMinimal.h"
 
+#include <type_traits>
+
+/**
+ * A move-only callable that stores small functors inline, so that queueing a game thread task doesn't need to
+ * allocate. Functors larger than the inline storage are moved onto the heap instead.
+ */
+class FSaveGameTask
+{
+public:
+	static constexpr SIZE_T InlineSize = 112;
+	static constexpr SIZE_T InlineAlignment = 16;
+
+	FSaveGameTask() = default;
+
+	template<typename FuncType, typename = std::enable_if_t<!std::is_same_v<std::decay_t<FuncType>, FSaveGameTask>>>
+	FSaveGameTask(FuncType&& Func)
+	{
+		using FFunctor = std::decay_t<FuncType>;
+
+		if constexpr (sizeof(FFunctor) <= InlineSize && alignof(FFunctor) <= InlineAlignment)
+		{
+			new (Storage) FFunctor(Forward<FuncType>(Func));
+			Ops = &TInlineOps<FFunctor>::Ops;
+		}
+		else
+		{
+			*reinterpret_cast<FFunctor**>(Storage) = new FFunctor(Forward<FuncType>(Func));
+			Ops = &THeapOps<FFunctor>::Ops;
+		}
+	}
+
+	FSaveGameTask(FSaveGameTask&& Other)
+	{
+		MoveFrom(Other);
+	}
+
+	FSaveGameTask& operator=(FSaveGameTask&& Other)
+	{
+		if (this != &Other)
+		{
+			Reset();
+			MoveFrom(Other);
+		}
+		return *this;
+	}
+
+	FSaveGameTask(const FSaveGameTask&) = delete;
+	FSaveGameTask& operator=(const FSaveGameTask&) = delete;
+
+	~FSaveGameTask()
+	{
+		Reset();
+	}
+
+	void operator()()
+	{
+		check(Ops);
+		Ops->Call(Storage);
+	}
+
+	explicit operator bool() const { return Ops != nullptr; }
+
+	void Reset()
+	{
+		if (Ops)
+		{
+			Ops->Destroy(Storage);
+			Ops = nullptr;
+		}
+	}
+
+private:
+	struct FOps
+	{
+		void (*Call)(void*);
+		void (*Move)(void* To, void* From);
+		void (*Destroy)(void*);
+	};
+
+	template<typename FFunctor>
+	struct TInlineOps
+	{
+		static void Call(void* Data) { (*static_cast<FFunctor*>(Data))(); }
+		static void Move(void* To, void* From)
+		{
+			new (To) FFunctor(MoveTemp(*static_cast<FFunctor*>(From)));
+			static_cast<FFunctor*>(From)->~FFunctor();
+		}
+		static void Destroy(void* Data) { static_cast<FFunctor*>(Data)->~FFunctor(); }
+
+		static constexpr FOps Ops = { &Call, &Move, &Destroy };
+	};
+
+	template<typename FFunctor>
+	struct THeapOps
+	{
+		static void Call(void* Data) { (**static_cast<FFunctor**>(Data))(); }
+		static void Move(void* To, void* From) { *static_cast<FFunctor**>(To) = *static_cast<FFunctor**>(From); }
+		static void Destroy(void* Data) { delete *static_cast<FFunctor**>(Data); }
+
+		static constexpr FOps Ops = { &Call, &Move, &Destroy };
+	};
+
+	void MoveFrom(FSaveGameTask& Other)
+	{
+		Ops = Other.Ops;
+
+		if (Ops)
+		{
+			Ops->Move(Storage, Other.Storage);
+			Other.Ops = nullptr;
+		}
+	}
+
+	alignas(InlineAlignment) uint8 Storage[InlineSize];
+	const FOps* Ops = nullptr;
+};
+
+/**
+ * A queue of tasks to run on the game thread, owned by a single save game operation (FSaveGameTheadScope).
+ * Each operation has its own queue, so independent saves/loads don't share any state.
+ */
 class ISaveGameThreadQueue
 {
 public:
-	typedef TFunction<void()> FTaskFunction;
+	typedef FSaveGameTask FTaskFunction;
 
+	/** Returns the queue of the operation that this thread is currently working on. Asserts if there isn't one. */
 	static ISaveGameThreadQueue& Get();
 
+	/** Returns the queue of the operation that this thread is currently working on, if any */
+	static ISaveGameThreadQueue* TryGet();
+
 	virtual ~ISaveGameThreadQueue() = default;
 	virtual void AddTask(FTaskFunction&& Task) = 0;
 };
 
+/**
+ * Marks a thread as working on behalf of an operation's queue for the lifetime of this scope, so that code without an
+ * explicit handle to the queue (i.e. Blueprint's CallOnGameThread) can find it with ISaveGameThreadQueue::Get.
+ */
+class FSaveGameThreadQueueContext
+{
+public:
+	explicit FSaveGameThreadQueueContext(ISaveGameThreadQueue& Queue);
+	~FSaveGameThreadQueueContext();
+
+private:
+	ISaveGameThreadQueue* PreviousQueue;
+};
+
+class FSaveGameThreadQueue;
+
+/** How an operation's game thread queue has been woken, useful for tuning how it waits */
+struct FSaveGameThreadQueueStats
+{
+	uint32 NumTasks = 0;
+	uint32 NumSpinWakes = 0;
+	uint32 NumYieldWakes = 0;
+	uint32 NumBlockWakes = 0;
+	uint32 NumTimeouts = 0;
+	double AverageInterArrivalSeconds = 0.0;
+};
+
+/** Creates a thread queue for an operation, which can only be processed by the thread that created it */
 class FSaveGameTheadScope
 {
 public:
-	FSaveGameTheadScope();
+	/** @param Capacity Tasks that can be queued without allocating (i.e. one per job), clamped to a sensible range */
+	explicit FSaveGameTheadScope(uint32 Capacity);
 	~FSaveGameTheadScope();
 
+	ISaveGameThreadQueue& GetQueue() const;
+
+	/**
+	 * Runs queued tasks until the queue has been empty for WaitCycles (in FTimespan ticks).
+	 * Waits adaptively, by spinning, yielding, then blocking, depending on how quickly tasks have been arriving.
+	 * @return true if any tasks were run
+	 */
 	bool ProcessThread(int64 WaitCycles) const;
+
+	const FSaveGameThreadQueueStats& GetStats() const;
+
+private:
+	TUniquePtr<FSaveGameThreadQueue> Queue;
+	TUniquePtr<FSaveGameThreadQueueContext> Context;
 };
@@ -0,0 +1,104 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameTrace.h"
+
+#if SAVEGAME_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_DEFINE(SaveGameChannel);
+
+UE_TRACE_EVENT_BEGIN(SaveGame, Phase)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(int32, NumActors)
+	UE_TRACE_EVENT_FIELD(uint8, Phase)
+	UE_TRACE_EVENT_FIELD(bool, IsLoading)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(SaveGame, Class, NoSync|Important)
+	UE_TRACE_EVENT_FIELD(uint32, Id)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Name)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(SaveGame, Actor)
+	UE_TRACE_EVENT_FIELD(uint64, StartCycle)
+	UE_TRACE_EVENT_FIELD(uint64, EndCycle)
+	UE_TRACE_EVENT_FIELD(uint64, Size)
+	UE_TRACE_EVENT_FIELD(uint32, ActorIndex)
+	UE_TRACE_EVENT_FIELD(uint32, ClassId)
+	UE_TRACE_EVENT_FIELD(uint8, Step)
+	UE_TRACE_EVENT_FIELD(bool, IsLoading)
+UE_TRACE_EVENT_END()
+
+namespace SaveGameTrace
+{
+	FRWLock TracedClassesLock;
+
+	/** The unique ids of classes whose names have been sent */
+	TSet<uint32> TracedClasses;
+
+	/** Sends the name of a class the first time it's seen, returns its id */
+	uint32 TraceClass(const UClass* TracedClass)
+	{
+		if (TracedClass == nullptr)
+		{
+			return 0;
+		}
+
+		const uint32 ClassId = TracedClass->GetUniqueID();
+
+		{
+			FReadScopeLock ReadLock(TracedClassesLock);
+			if (TracedClasses.Contains(ClassId))
+			{
+				return ClassId;
+			}
+		}
+
+		bool bAlreadyTraced;
+		{
+			FWriteScopeLock WriteLock(TracedClassesLock);
+			TracedClasses.Add(ClassId, &bAlreadyTraced);
+		}
+
+		if (!bAlreadyTraced)
+		{
+			const FString ClassName = TracedClass->GetPathName();
+
+			UE_TRACE_LOG(SaveGame, Class, SaveGameChannel)
+				<< Class.Id(ClassId)
+				<< Class.Name(*ClassName, ClassName.Len());
+		}
+
+		return ClassId;
+	}
+}
+
+void FSaveGameTrace::OutputPhase(ESaveGamePhase InPhase, bool bIsLoading, int32 NumActors)
+{
+	UE_TRACE_LOG(SaveGame, Phase, SaveGameChannel)
+		<< Phase.Cycle(FPlatformTime::Cycles64())
+		<< Phase.NumActors(NumActors)
+		<< Phase.Phase(static_cast<uint8>(InPhase))
+		<< Phase.IsLoading(bIsLoading);
+}
+
+void FSaveGameTrace::OutputActor(ESaveGameTraceStep Step, bool bIsLoading, int32 ActorIdx, const UClass* ActorClass,
+	uint64 StartCycle, uint64 EndCycle, uint64 Size)
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+
+	const uint32 ClassId = SaveGameTrace::TraceClass(ActorClass);
+
+	UE_TRACE_LOG(SaveGame, Actor, SaveGameChannel)
+		<< Actor.StartCycle(StartCycle)
+		<< Actor.EndCycle(EndCycle)
+		<< Actor.Size(Size)
+		<< Actor.ActorIndex(ActorIdx)
+		<< Actor.ClassId(ClassId)
+		<< Actor.Step(static_cast<uint8>(Step))
+		<< Actor.IsLoading(bIsLoading);
+}
+
+#endif
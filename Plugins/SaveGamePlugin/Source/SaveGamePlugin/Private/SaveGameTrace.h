@@ -0,0 +1,97 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "SaveGameOperation.h"
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+#define SAVEGAME_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+
+/** The steps of an actor that are traced */
+enum class ESaveGameTraceStep : uint8
+{
+	InitializeActor,
+	SerializeProperties,
+	OnSerialize,
+};
+
+#if SAVEGAME_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_EXTERN(SaveGameChannel);
+
+/**
+ * Outputs save game events to the "SaveGame" trace channel (enable with -trace=savegame).
+ *
+ * Events only carry indices and ids, class names are sent once per class, so that per-actor events are cheap.
+ * When the channel is disabled, the cost is a single check of the channel.
+ */
+struct FSaveGameTrace
+{
+	static bool IsEnabled() { return UE_TRACE_CHANNELEXPR_IS_ENABLED(SaveGameChannel); }
+
+	static void OutputPhase(ESaveGamePhase InPhase, bool bIsLoading, int32 NumActors);
+
+	static void OutputActor(ESaveGameTraceStep Step, bool bIsLoading, int32 ActorIdx, const UClass* ActorClass,
+		uint64 StartCycle, uint64 EndCycle, uint64 Size);
+};
+
+/** Traces a step of an actor, using how far the actor's archive moved as its size */
+class FSaveGameActorTraceScope
+{
+public:
+	FSaveGameActorTraceScope(ESaveGameTraceStep InStep, bool bInIsLoading, int32 InActorIdx, const FArchive& InArchive)
+		: Archive(FSaveGameTrace::IsEnabled() ? &InArchive : nullptr)
+		, Class(nullptr)
+		, ActorIdx(InActorIdx)
+		, Step(InStep)
+		, bIsLoading(bInIsLoading)
+	{
+		if (Archive)
+		{
+			StartPosition = Archive->Tell();
+			StartCycle = FPlatformTime::Cycles64();
+		}
+	}
+
+	~FSaveGameActorTraceScope()
+	{
+		if (Archive)
+		{
+			const uint64 Size = FMath::Max<int64>(Archive->Tell() - StartPosition, 0);
+			FSaveGameTrace::OutputActor(Step, bIsLoading, ActorIdx, Class, StartCycle, FPlatformTime::Cycles64(), Size);
+		}
+	}
+
+	/** The class isn't always known up front (i.e. when loading an actor that hasn't been spawned yet) */
+	void SetClass(const UClass* InClass) { Class = InClass; }
+
+private:
+	const FArchive* Archive;
+	const UClass* Class;
+	int64 StartPosition = 0;
+	uint64 StartCycle = 0;
+	int32 ActorIdx;
+	ESaveGameTraceStep Step;
+	bool bIsLoading;
+};
+
+#define TRACE_SAVEGAME_PHASE(Phase, bIsLoading, NumActors) \
+	FSaveGameTrace::OutputPhase(Phase, bIsLoading, NumActors)
+
+#define TRACE_SAVEGAME_ACTOR_SCOPE(ScopeName, Step, bIsLoading, ActorIdx, Archive) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(SaveGame_##Step, SaveGameChannel); \
+	FSaveGameActorTraceScope ScopeName(ESaveGameTraceStep::Step, bIsLoading, ActorIdx, Archive)
+
+#define TRACE_SAVEGAME_ACTOR_CLASS(ScopeName, Class) \
+	ScopeName.SetClass(Class)
+
+#else
+
+#define TRACE_SAVEGAME_PHASE(Phase, bIsLoading, NumActors)
+#define TRACE_SAVEGAME_ACTOR_SCOPE(ScopeName, Step, bIsLoading, ActorIdx, Archive)
+#define TRACE_SAVEGAME_ACTOR_CLASS(ScopeName, Class)
+
+#endif
@@ -0,0 +1,53 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameTransformBatch.h"
+
+#include "Components/SceneComponent.h"
+#include "GameFramework/Actor.h"
+
+void FSaveGameTransformBatch::Reset(int32 NumActors)
+{
+	Entries.Reset();
+	Entries.SetNum(NumActors);
+}
+
+void FSaveGameTransformBatch::Set(int32 ActorIdx, AActor* Actor, const FTransform& Transform)
+{
+	FEntry& Entry = Entries[ActorIdx];
+	Entry.Actor = Actor;
+	Entry.Transform = Transform;
+}
+
+void FSaveGameTransformBatch::Apply()
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_SaveGame_ApplyTransforms);
+
+	check(IsInGameThread());
+
+	// Reserved up front, so that each scope stays at the address that its component's scope stack points to
+	TArray<TUniquePtr<FScopedMovementUpdate>> MovementUpdates;
+	MovementUpdates.Reserve(Entries.Num());
+
+	for (const FEntry& Entry : Entries)
+	{
+		AActor* Actor = Entry.Actor.Get();
+		USceneComponent* RootComponent = Actor ? Actor->GetRootComponent() : nullptr;
+
+		if (!RootComponent)
+		{
+			continue;
+		}
+
+		// Updates the attached components and overlaps once every actor has moved, rather than as part of the move
+		MovementUpdates.Add(MakeUnique<FScopedMovementUpdate>(RootComponent, EScopedUpdate::DeferredUpdates));
+		Actor->SetActorTransform(Entry.Transform, false, nullptr, ETeleportType::TeleportPhysics);
+	}
+
+	// Scoped movement updates have to end in the reverse order that they started
+	for (int32 UpdateIdx = MovementUpdates.Num() - 1; UpdateIdx >= 0; --UpdateIdx)
+	{
+		MovementUpdates[UpdateIdx].Reset();
+	}
+
+	Entries.Empty();
+}
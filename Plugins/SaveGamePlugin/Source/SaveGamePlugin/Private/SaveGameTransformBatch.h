@@ -0,0 +1,35 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * The actor transforms read by a load, applied together on the game thread once every actor has been serialized.
+ *
+ * USaveGameFunctionLibrary::SerializeActorTransform writes each actor's transform into its own slot (instead of
+ * queueing a game thread task per actor), so that serialize jobs never contend for the batch. Every actor is then
+ * moved with its movement updates deferred until the whole batch has moved, so that components' transforms and
+ * overlaps are only updated once, against the actors' final positions.
+ */
+class FSaveGameTransformBatch
+{
+public:
+	/** Empties the batch, and makes a slot for each of the load's actors */
+	void Reset(int32 NumActors);
+
+	/** Thread-safe, as long as each slot is only set by its actor's job */
+	void Set(int32 ActorIdx, AActor* Actor, const FTransform& Transform);
+
+	/** Sets the transforms of the actors that are still valid, then empties the batch. Must be called on the game thread. */
+	void Apply();
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FTransform Transform;
+	};
+
+	TArray<FEntry> Entries;
+};
@@ -0,0 +1,58 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/SparseArray.h"
+
+/**
+ * Keeps track of the actors that should be saved.
+ *
+ * Actors are stored in dense slot arrays (with free lists), with one slot array per class. An actor's slot is found
+ * by its UObject index, so registering and unregistering are O(1) without any hashing. Iterating the registry will
+ * then return actors grouped by their class.
+ */
+class FSaveGameActorRegistry
+{
+public:
+	/** Registers an actor, does nothing if already registered */
+	void Add(AActor* Actor);
+
+	/** Unregisters an actor, returns false if the actor wasn't registered */
+	bool Remove(const AActor* Actor);
+
+	bool Contains(const AActor* Actor) const;
+
+	void Reset();
+
+	int32 Num() const { return NumActors; }
+
+	/** Fills the array with all of the registered actors, grouped by class */
+	void GetActors(TArray<TWeakObjectPtr<AActor>>& OutActors) const;
+
+private:
+	struct FSlot
+	{
+		int32 Bucket = INDEX_NONE;
+		int32 Index = INDEX_NONE;
+	};
+
+	struct FClassBucket
+	{
+		TWeakObjectPtr<UClass> Class;
+		TSparseArray<TWeakObjectPtr<AActor>> Actors;
+	};
+
+	int32 FindOrAddBucket(UClass* Class);
+	const FSlot* FindSlot(const AActor* Actor) const;
+
+	TArray<FClassBucket> Buckets;
+
+	/** Indexed by a class's UObject index, the bucket that the class's actors are stored in */
+	TArray<int32> ClassBuckets;
+
+	/** Indexed by an actor's UObject index, where the actor is stored */
+	TArray<FSlot> ActorSlots;
+
+	int32 NumActors = 0;
+};
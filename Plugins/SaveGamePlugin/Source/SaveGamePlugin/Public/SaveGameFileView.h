@@ -0,0 +1,121 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "SaveGameSlotInfo.h"
+
+#include "CoreMinimal.h"
+#include "Misc/EngineVersion.h"
+#include "Serialization/CustomVersion.h"
+#include "Serialization/StructuredArchive.h"
+#include "Templates/PimplPtr.h"
+#include "UObject/ObjectVersion.h"
+#include "UObject/SoftObjectPath.h"
+
+/**
+ * A read-only view of a save game, for reading individual fields of an actor without loading the world
+ * (i.e. the player's level for a slot's card in a menu).
+ *
+ * Opening a view reads the save, but only decompresses the parts of it that are read: the header, the versions and
+ * the actor index (saves made since FSaveGameVersion::ActorIndex). Reading a field then seeks to the actor's custom
+ * data and looks the field up in the offset table written by FSaveGameArchive, so the rest of the save (including
+ * the actor's properties) isn't decompressed at all. Saves from before the slot header's CompressedChunks version
+ * are decompressed as a whole, and older saves without an actor index read the start of each actor when opened.
+ *
+ * Only fields in the actor's custom data (i.e. from ISaveGameObject::OnSerialize) can be read, and only from saves
+ * made since FSaveGameVersion::ActorDataOffsets. A view can be read from multiple threads once opened.
+ */
+class SAVEGAMEPLUGIN_API FSaveGameFileView
+{
+public:
+	/** Reads a slot through the platform's save game system, returns false if it couldn't be read */
+	bool Open(const FString& SlotName);
+
+	/** Opens the contents of a save game file, returns false if it couldn't be read */
+	bool Open(TArray<uint8>&& FileData);
+
+	bool IsOpen() const { return !Data.IsEmpty(); }
+
+	/** The slot's metadata, empty if the save was made before it had any */
+	const FSaveGameSlotInfo& GetSlotInfo() const { return SlotInfo; }
+
+	/** The package name of the map that was saved */
+	const FString& GetMapName() const { return MapName; }
+
+	int32 NumActors() const { return Actors.Num(); }
+
+	/** Finds an actor by the name it was saved with, returns INDEX_NONE if it wasn't saved */
+	int32 FindActor(FName ActorName) const;
+
+	FName GetActorName(int32 ActorIdx) const { return Actors[ActorIdx].Name; }
+
+	/** The class that the actor was spawned with, null if it's a level actor */
+	const FSoftClassPath& GetActorClass(int32 ActorIdx) const { return Actors[ActorIdx].Class; }
+
+	/** Returns true if the actor's custom data has this field */
+	bool HasField(int32 ActorIdx, FName FieldName) const;
+
+	/**
+	 * Reads a field from the actor's custom data, as written by FSaveGameArchive::SerializeField.
+	 *
+	 * @param ReadFunction Reads the value from the field's slot, should match how the field was written
+	 * @return true if the field exists and was read
+	 */
+	bool ReadField(int32 ActorIdx, FName FieldName, TFunctionRef<void(FStructuredArchive::FSlot)> ReadFunction) const;
+
+	/** Reads a field into the value of a property, i.e. for fields written by USaveGameFunctionLibrary::SerializeItem */
+	bool ReadField(int32 ActorIdx, FName FieldName, const FProperty* Property, void* OutValue) const;
+
+	template<typename ValueType>
+	bool ReadField(int32 ActorIdx, FName FieldName, ValueType& OutValue) const
+	{
+		return ReadField(ActorIdx, FieldName, [&OutValue](FStructuredArchive::FSlot Slot)
+		{
+			Slot << OutValue;
+		});
+	}
+
+private:
+	struct FActorEntry
+	{
+		FName Name;
+		FSoftClassPath Class;
+
+		/** Where the actor starts in the data */
+		uint64 Offset;
+	};
+
+	class FChunkReader;
+	class FReader;
+	struct FChunkedData;
+
+	bool IndexActors();
+
+	/**
+	 * Makes sure that this range of the data has been decompressed. Thread-safe.
+	 * @param OutStart, OutEnd The (larger) range that was decompressed along with it
+	 */
+	bool FetchData(int64 Offset, int64 Size, int64& OutStart, int64& OutEnd) const;
+
+	/** Finds where a field starts, by reading the actor's field offset table */
+	bool FindField(FReader& Reader, int32 ActorIdx, FName FieldName, uint64& OutFieldOffset) const;
+
+	/** The decompressed save, mutable as its chunks are decompressed on demand (see FetchData) */
+	mutable TArray<uint8> Data;
+
+	/** Only set if the save is compressed in chunks, which of them have been decompressed so far */
+	TPimplPtr<FChunkedData> ChunkedData;
+
+	FSaveGameSlotInfo SlotInfo;
+
+	FString MapName;
+	FEngineVersion EngineVersion;
+	FPackageFileVersion PackageVersion;
+	FCustomVersionContainer CustomVersions;
+
+	/** Each actor starts with the offset to its custom data, since FSaveGameVersion::ActorDataOffsets */
+	bool bHasDataOffsets = false;
+
+	/** Sorted by name, for binary searching */
+	TArray<FActorEntry> Actors;
+};
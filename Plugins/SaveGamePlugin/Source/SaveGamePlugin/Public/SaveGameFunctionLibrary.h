@@ -34,7 +34,7 @@ public:
 
 	/**
 	 * Helper method to serialize an actor's transform if the actor is movable.
-	 * If loading, will set the actor's transform.
+	 * If loading, will set the actor's transform. Quantized if USaveGameSettings::bQuantizeTransforms is enabled.
 	 *
 	 * @param Archive The archive that the save game is serializing
 	 * @param Actor The actor whose transform will be serialized
@@ -25,11 +25,15 @@ public:
 	FSaveGameArchive()
 		: Record(nullptr)
 		, Object(nullptr)
+		, ThreadQueue(nullptr)
+		, TransformBatch(nullptr)
+		, TransformBatchIdx(INDEX_NONE)
 		, StartPosition(0)
 		, EndPosition(0)
 	{}
 
-	FSaveGameArchive(class FStructuredArchive::FRecord& InRecord, UObject* InObject);
+	FSaveGameArchive(class FStructuredArchive::FRecord& InRecord, UObject* InObject, class ISaveGameThreadQueue* InThreadQueue = nullptr,
+		class FSaveGameTransformBatch* InTransformBatch = nullptr, int32 InTransformBatchIdx = INDEX_NONE);
 	~FSaveGameArchive();
 
 	bool IsValid() const
@@ -42,6 +46,24 @@ public:
 		return *Record;
 	}
 
+	/** The game thread queue of the operation that owns this archive, if any */
+	class ISaveGameThreadQueue* GetThreadQueue() const
+	{
+		return ThreadQueue;
+	}
+
+	/** When loading, where the operation that owns this archive collects actor transforms to apply together, if any */
+	class FSaveGameTransformBatch* GetTransformBatch() const
+	{
+		return TransformBatch;
+	}
+
+	/** The slot in the transform batch that belongs to this archive's actor */
+	int32 GetTransformBatchIdx() const
+	{
+		return TransformBatchIdx;
+	}
+
 	/**
 	 * Serializes a field with a custom lambda function. If a binary format, stores its offset for out-of-order reading.
 	 * @param FieldName Name of the field that's being serialized
@@ -93,6 +115,9 @@ private:
 
 	class FStructuredArchive::FRecord* Record;
 	TWeakObjectPtr<> Object;
+	class ISaveGameThreadQueue* ThreadQueue;
+	class FSaveGameTransformBatch* TransformBatch;
+	int32 TransformBatchIdx;
 	uint64 StartPosition;
 	uint64 EndPosition;
 
@@ -139,6 +164,7 @@ public:
 	/**
 	 * Returns true when the programmer is confident that the OnSerialize event is thread-safe.
 	 * Must be implemented in a thread-safe fashion (i.e. return true or false only).
+	 * This is only queried once per class (on its default object), so shouldn't vary between instances.
 	 */
 	UFUNCTION(BlueprintNativeEvent, Category=SaveGame, meta=(BlueprintThreadSafe))
 	bool IsThreadSafe() const;
@@ -163,7 +189,10 @@ class SAVEGAMEPLUGIN_API ISaveGameSpawnActor
 	GENERATED_BODY()
 
 public:
-	/** Returns a unique Spawn ID for this Actor */
+	/**
+	 * Returns a unique Spawn ID for this Actor. The save game subsystem indexes this once the actor has spawned,
+	 * so it shouldn't change afterwards.
+	 */
 	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category="SaveGame|Spawn")
 	const FGuid GetSpawnID() const;
 
@@ -0,0 +1,119 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "Tasks/Task.h"
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+
+#include <atomic>
+
+#include "SaveGameOperation.generated.h"
+
+class FSaveGameSerializer;
+
+/** The phases that a save or load goes through, in order */
+UENUM(BlueprintType)
+enum class ESaveGamePhase : uint8
+{
+	/** Queued behind another operation */
+	Pending,
+	/** Load: Reading the save game from disk */
+	Read,
+	/** Load: Decompressing the save game data */
+	Decompress,
+	/** Load: Travelling to the saved map */
+	MapLoad,
+	/** Spawning (on load) or gathering (on save) each actor */
+	InitializeActors,
+	/** Serializing each actor's properties and data */
+	SerializeActors,
+	/** Save: Merging, compressing and writing the save game to disk */
+	Write,
+	/** Finished successfully */
+	Complete,
+	/** Stopped before it could finish (i.e. replaced by a newer save, or the save game couldn't be read) */
+	Cancelled,
+};
+
+USTRUCT(BlueprintType)
+struct FSaveGameProgress
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="SaveGamePlugin|Operation")
+	ESaveGamePhase Phase = ESaveGamePhase::Pending;
+
+	/** Number of actors processed in the current phase */
+	UPROPERTY(BlueprintReadOnly, Category="SaveGamePlugin|Operation")
+	int32 CompletedActors = 0;
+
+	/** Number of actors to process in the current phase, zero if the phase doesn't process actors */
+	UPROPERTY(BlueprintReadOnly, Category="SaveGamePlugin|Operation")
+	int32 TotalActors = 0;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FSaveGamePhaseChangedSignature, USaveGameOperation*, Operation, ESaveGamePhase, Phase);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FSaveGameCompletedSignature, USaveGameOperation*, Operation, bool, bSuccess);
+
+/**
+ * A handle to a save or load that's in progress, returned by USaveGameSubsystem::SaveAsync and LoadAsync.
+ *
+ * Progress can be polled from any thread. Delegates are always broadcast on the game thread.
+ */
+UCLASS(BlueprintType)
+class SAVEGAMEPLUGIN_API USaveGameOperation : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintPure, Category="SaveGamePlugin|Operation")
+	bool IsLoading() const { return bIsLoading; }
+
+	/** Returns true once the operation has completed or has been cancelled */
+	UFUNCTION(BlueprintPure, Category="SaveGamePlugin|Operation")
+	bool IsDone() const;
+
+	UFUNCTION(BlueprintPure, Category="SaveGamePlugin|Operation")
+	ESaveGamePhase GetPhase() const { return Phase.load(std::memory_order_relaxed); }
+
+	UFUNCTION(BlueprintPure, Category="SaveGamePlugin|Operation")
+	FSaveGameProgress GetProgress() const;
+
+	/** Requests that a save stops at its next phase boundary. Loads can't be cancelled. */
+	UFUNCTION(BlueprintCallable, Category="SaveGamePlugin|Operation")
+	void Cancel();
+
+	/** An event that's triggered once this operation is done, can be waited on or used as a task prerequisite */
+	UE::Tasks::FTaskEvent GetTask() const { return CompletedEvent; }
+
+	/** Broadcast on the game thread whenever the operation enters a new phase */
+	UPROPERTY(BlueprintAssignable, Category="SaveGamePlugin|Operation")
+	FSaveGamePhaseChangedSignature OnPhaseChanged;
+
+	/** Broadcast on the game thread once the operation has completed or has been cancelled */
+	UPROPERTY(BlueprintAssignable, Category="SaveGamePlugin|Operation")
+	FSaveGameCompletedSignature OnCompleted;
+
+private:
+	friend class USaveGameSubsystem;
+	friend class FSaveGameSerializer;
+
+	void Initialize(const TSharedRef<FSaveGameSerializer>& InSerializer, bool bInIsLoading);
+
+	/** Can be called from any thread */
+	void SetPhase(ESaveGamePhase NewPhase, int32 InTotalActors = 0);
+	void AddCompletedActor() { CompletedActors.fetch_add(1, std::memory_order_relaxed); }
+
+	/** Called once the operation has finished, from any thread */
+	void Finish(bool bSuccess);
+
+	TWeakPtr<FSaveGameSerializer> Serializer;
+	UE::Tasks::FTaskEvent CompletedEvent = UE::Tasks::FTaskEvent(TEXT("SaveGameOperation"));
+	bool bIsLoading = false;
+
+	std::atomic<ESaveGamePhase> Phase = ESaveGamePhase::Pending;
+	std::atomic<int32> CompletedActors = 0;
+	std::atomic<int32> TotalActors = 0;
+};
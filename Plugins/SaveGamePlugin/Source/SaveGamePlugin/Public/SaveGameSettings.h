@@ -6,6 +6,23 @@
 #include "Engine/DeveloperSettings.h"
 #include "SaveGameSettings.generated.h"
 
+class AActor;
+
+/** The order that actors are written to a save game in */
+UENUM()
+enum class ESaveGameActorOrder : uint8
+{
+	/** The order that actors were registered in. This is the cheapest, but can vary between saves of the same world. */
+	Registration,
+	/** Sorted by level and name, so that saves of the same world have the same data */
+	Deterministic,
+	/**
+	 * Grouped by class, then sorted by location (in Morton order), so that similar actors are next to each other.
+	 * This compresses better than the other orders, and also means that saves of the same world have the same data.
+	 */
+	Clustered,
+};
+
 USTRUCT(BlueprintType, BlueprintInternalUseOnly)
 struct FSaveGameVersionInfo
 {
@@ -38,6 +55,44 @@ public:
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif
 
+	/** The maximum number of save games that USaveGameSubsystem::Prefetch will keep decoded in memory */
+	UPROPERTY(EditAnywhere, Config, Category=Load, meta=(ClampMin=0))
+	int32 MaxPrefetchedSaves = 2;
+
+	/**
+	 * The order that actors are written in. Any order other than Registration will write the same bytes for the same
+	 * world, regardless of how many threads saved it (excluding the slot's header, as it has the time it was saved).
+	 */
+	UPROPERTY(EditAnywhere, Config, Category=Save)
+	ESaveGameActorOrder ActorOrder = ESaveGameActorOrder::Registration;
+
+	/**
+	 * Classes whose SaveGame properties are stored as columns (one contiguous array per property), instead of per
+	 * actor. Intended for classes with thousands of instances, as it's smaller and faster to save and load. Only
+	 * applies to exactly these classes (not their subclasses), and only if all of their SaveGame properties are
+	 * bools, numbers, enums or plain old data structs without padding.
+	 */
+	UPROPERTY(EditAnywhere, Config, Category=Save)
+	TArray<TSoftClassPtr<AActor>> ColumnarClasses;
+
+	/**
+	 * Whether USaveGameFunctionLibrary::SerializeActorTransform quantizes transforms (see TransformPrecision), rather
+	 * than storing them at full precision. Saves made either way can be loaded regardless of this setting.
+	 */
+	UPROPERTY(EditAnywhere, Config, Category=Save)
+	bool bQuantizeTransforms = false;
+
+	/** The largest error in a quantized transform's location, in world units. Rotations are accurate to about 0.0001. */
+	UPROPERTY(EditAnywhere, Config, Category=Save, meta=(EditCondition="bQuantizeTransforms", ClampMin=0.0001))
+	float TransformPrecision = 0.01f;
+
+	/**
+	 * Whether to save the velocities and sleep state of the saved actors' simulating primitives (i.e. physics props),
+	 * so that they carry on moving (or stay asleep) when loaded. These are gathered for every saved actor at once.
+	 */
+	UPROPERTY(EditAnywhere, Config, Category=Save)
+	bool bSavePhysicsStates = false;
+
 protected:
 	/**
 	 * The list of possible versions and their corresponding enums. Must add versions here before
@@ -0,0 +1,42 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SaveGameSlotInfo.generated.h"
+
+/**
+ * The metadata of a save game slot. This is stored uncompressed at the start of the save game file,
+ * so that it can be read without loading or decompressing the rest of the save.
+ */
+USTRUCT(BlueprintType)
+struct SAVEGAMEPLUGIN_API FSaveGameSlotInfo
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category="SaveGamePlugin|Slot")
+	FString SlotName;
+
+	/** The package name of the map that was saved */
+	UPROPERTY(BlueprintReadOnly, Category="SaveGamePlugin|Slot")
+	FString MapName;
+
+	/** When the slot was saved, in UTC */
+	UPROPERTY(BlueprintReadOnly, Category="SaveGamePlugin|Slot")
+	FDateTime Timestamp;
+
+	/** Total play time in seconds, see USaveGameSubsystem::GetPlayTime */
+	UPROPERTY(BlueprintReadOnly, Category="SaveGamePlugin|Slot")
+	double PlayTime = 0.0;
+
+	/** The FSaveGameVersion that the slot was saved with */
+	UPROPERTY(BlueprintReadOnly, Category="SaveGamePlugin|Slot")
+	int32 Version = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category="SaveGamePlugin|Slot")
+	FString EngineVersion;
+
+	/** Game specific fields, see USaveGameSubsystem::SlotUserData */
+	UPROPERTY(BlueprintReadOnly, Category="SaveGamePlugin|Slot")
+	TMap<FString, FString> UserData;
+};
@@ -2,12 +2,17 @@
 
 #pragma once
 
+#include "SaveGameActorRegistry.h"
+#include "SaveGameOperation.h"
+#include "SaveGameSlotInfo.h"
 #include "Tasks/Pipe.h"
 
 #include "CoreMinimal.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "SaveGameSubsystem.generated.h"
 
+class FSaveGameSerializer;
+
 /**
  * The subsystem that manages the lifetime of a save game.
  */
@@ -20,27 +25,114 @@ public:
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	virtual void Deinitialize() override;
 
+	/**
+	 * Saves the current world to a slot. If a save to the same slot is already waiting to start, this request
+	 * is merged into it. Any save to the same slot that's already in progress will be cancelled at its next
+	 * phase boundary.
+	 */
 	UFUNCTION(BlueprintCallable, Category="SaveGamePlugin|Save")
-	void Save();
+	void Save(const FString& SlotName = TEXT("SaveGame"));
+
+	/** Loads a slot, cancelling any saves that are waiting or in progress */
+	UFUNCTION(BlueprintCallable, Category="SaveGamePlugin|Load")
+	void Load(const FString& SlotName = TEXT("SaveGame"));
+
+	/** Same as Save, but returns a handle for tracking the save's progress and completion */
+	UFUNCTION(BlueprintCallable, Category="SaveGamePlugin|Save")
+	USaveGameOperation* SaveAsync(const FString& SlotName = TEXT("SaveGame"));
+
+	/** Same as Load, but returns a handle for tracking the load's progress and completion */
+	UFUNCTION(BlueprintCallable, Category="SaveGamePlugin|Load")
+	USaveGameOperation* LoadAsync(const FString& SlotName = TEXT("SaveGame"));
 
+	/**
+	 * Starts reading and decoding a slot in the background, so that a following Load can skip straight
+	 * to travelling to the saved map. Useful for when a player hovers over or selects a save in a menu.
+	 * Does nothing while a save is waiting or in progress, as it would read what's about to be replaced.
+	 */
 	UFUNCTION(BlueprintCallable, Category="SaveGamePlugin|Load")
-	void Load();
+	void Prefetch(const FString& SlotName = TEXT("SaveGame"));
+
+	/** Discards any save games that have been prefetched */
+	UFUNCTION(BlueprintCallable, Category="SaveGamePlugin|Load")
+	void ClearPrefetched();
 
 	UFUNCTION(BlueprintCallable, Category="SaveGamePlugin|Load")
 	bool IsLoadingSaveGame() const;
 
+	/**
+	 * Lists the metadata of every save game slot, most recently saved first. Only each slot's header is read,
+	 * and slots are read in parallel.
+	 */
+	UFUNCTION(BlueprintCallable, Category="SaveGamePlugin|Slot")
+	TArray<FSaveGameSlotInfo> ListSlots() const;
+
+	/** The time played in seconds, including the play time of the slot that was last loaded */
+	UFUNCTION(BlueprintPure, Category="SaveGamePlugin|Slot")
+	double GetPlayTime() const;
+
+	/** Game specific fields that are stored in the metadata of the next save, and restored when a slot is loaded */
+	UPROPERTY(BlueprintReadWrite, Transient, Category="SaveGamePlugin|Slot")
+	TMap<FString, FString> SlotUserData;
+
 protected:
 	void OnWorldInitialized(UWorld* World, const UWorld::InitializationValues);
 	void OnActorsInitialized(const FActorsInitializedParams& Params);
 	void OnWorldCleanup(UWorld* World, bool, bool);
 
 	void OnActorPreSpawn(AActor* Actor);
+	void OnActorSpawned(AActor* Actor);
 	void OnActorDestroyed(AActor* Actor);
 
+	/** Adds a spawn actor to the SpawnID index, using its current SpawnID */
+	void AddSpawnID(AActor* Actor);
+
+	/** Removes a spawn actor from the SpawnID index, if its current SpawnID maps to it */
+	void RemoveSpawnID(AActor* Actor);
+
 private:
 	template<bool> friend class TSaveGameSerializer;
+	friend class USaveGameOperation;
+
+	USaveGameOperation* CreateOperation(const TSharedRef<FSaveGameSerializer>& Serializer);
+
+	/** Removes and returns the prefetched load for this save, if there is one */
+	TSharedPtr<FSaveGameSerializer> TakePrefetched(const FString& SaveName);
+
+	/** Drops a prefetched load, keeping it alive until anything that it's still reading has finished */
+	static void ReleasePrefetched(TSharedPtr<FSaveGameSerializer>&& Serializer);
+
+	/** Captures the metadata for a slot that's being saved, must be called on the game thread */
+	FSaveGameSlotInfo GatherSlotInfo() const;
+
+	/** Restores the play time and user data from a slot that has been loaded, must be called on the game thread */
+	void RestoreSlotInfo(const FSaveGameSlotInfo& SlotInfo);
+
+	/** Operations that are still in flight */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<USaveGameOperation>> ActiveOperations;
+
 	UE::Tasks::FPipe SaveGamePipe = UE::Tasks::FPipe(TEXT("SaveGameSubsystem"));
 
+	/** Guards PendingSaves and ActiveSaves, which are accessed from the game thread and the pipe */
+	FCriticalSection SaveRequestsSection;
+
+	/** Saves that have been queued in the pipe, but haven't started yet, by slot name */
+	TMap<FString, TSharedPtr<FSaveGameSerializer>> PendingSaves;
+
+	/** Saves that are currently running, by slot name */
+	TMap<FString, TSharedPtr<FSaveGameSerializer>> ActiveSaves;
+
+	/** The play time of the slot that was last loaded, and when it was loaded */
+	double LoadedPlayTime = 0.0;
+	double LoadedPlayTimeStart = 0.0;
+
+	/** Loads that have been prepared ahead of time by Prefetch, by save name and least recently used first */
+	TArray<TPair<FString, TSharedPtr<FSaveGameSerializer>>> PrefetchedLoads;
+
 	TSet<FSoftObjectPath> DestroyedLevelActors;
-	TSet<TWeakObjectPtr<AActor>> SaveGameActors;
+	FSaveGameActorRegistry SaveGameActors;
+
+	/** Live actors that implement ISaveGameSpawnActor, mapped by their SpawnID. Only accessed on the game thread. */
+	TMap<FGuid, TWeakObjectPtr<AActor>> SpawnIDs;
 };
@@ -10,6 +10,24 @@ class SAVEGAMEPLUGIN_API FSaveGameVersion
 public:
 	enum Type
 	{
+		// Before any version changes were made
+		BeforeCustomVersionWasAdded = 0,
+
+		// Each actor stores the offset to its custom data, so it can be read without reading its properties
+		ActorDataOffsets,
+
+		// The actors are followed by an index of their names and classes, so they can be listed without reading each one
+		ActorIndex,
+
+		// The SaveGame properties of columnar classes are stored as columns after the versions, actors store their row (if there are columns)
+		ColumnarProperties,
+
+		// The physics states of simulating primitives are stored after the columns
+		PhysicsStates,
+
+		// SaveGame arrays of plain old data are stored as a block after each actor's properties
+		BulkArrays,
+
 		// -----<new versions can be added above this line>-------------------------------------------------
 		VersionPlusOne,
 		LatestVersion = VersionPlusOne - 1
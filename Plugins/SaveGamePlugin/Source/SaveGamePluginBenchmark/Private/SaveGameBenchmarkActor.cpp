@@ -0,0 +1,82 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameBenchmarkActor.h"
+
+#include "SaveGameFunctionLibrary.h"
+
+#include "Components/SceneComponent.h"
+
+ASaveGameBenchmarkActor::ASaveGameBenchmarkActor()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	// Needs to be movable, otherwise the transform isn't saved
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent->SetMobility(EComponentMobility::Movable);
+}
+
+void ASaveGameBenchmarkActor::Randomize(FRandomStream& Random, ESaveGameBenchmarkProperties InProperties)
+{
+	Properties = static_cast<uint8>(InProperties);
+
+	if (EnumHasAnyFlags(InProperties, ESaveGameBenchmarkProperties::Scalars))
+	{
+		IntValue = Random.RandHelper(MAX_int32);
+		FloatValue = Random.GetFraction();
+		bBoolValue = Random.RandHelper(2) == 1;
+		VectorValue = Random.GetUnitVector() * Random.FRandRange(1.0f, 10000.0f);
+	}
+
+	if (EnumHasAnyFlags(InProperties, ESaveGameBenchmarkProperties::Strings))
+	{
+		StringValue = FString::Printf(TEXT("Benchmark String %08x"), Random.GetUnsignedInt());
+
+		// Only a handful of distinct names, as most games reuse the same names
+		NameValue = FName(TEXT("BenchmarkName"), Random.RandHelper(16));
+	}
+
+	if (EnumHasAnyFlags(InProperties, ESaveGameBenchmarkProperties::Arrays))
+	{
+		IntArray.SetNumUninitialized(Random.RandRange(8, 64));
+		for (int32& Value : IntArray)
+		{
+			Value = Random.RandHelper(MAX_int32);
+		}
+
+		VectorArray.SetNumUninitialized(Random.RandRange(4, 16));
+		for (FVector& Value : VectorArray)
+		{
+			Value = Random.GetUnitVector();
+		}
+	}
+
+	if (EnumHasAnyFlags(InProperties, ESaveGameBenchmarkProperties::Custom))
+	{
+		SetActorTransform(FTransform(
+			FRotator(Random.FRandRange(-180.0f, 180.0f), Random.FRandRange(-180.0f, 180.0f), 0.0f),
+			Random.GetUnitVector() * Random.FRandRange(1.0f, 10000.0f)));
+
+		Samples.SetNumUninitialized(Random.RandRange(16, 128));
+		for (float& Value : Samples)
+		{
+			Value = Random.GetFraction();
+		}
+	}
+}
+
+bool ASaveGameBenchmarkActor::OnSerialize_Implementation(FSaveGameArchive& Archive, bool bIsLoading)
+{
+	if (!EnumHasAnyFlags(static_cast<ESaveGameBenchmarkProperties>(Properties), ESaveGameBenchmarkProperties::Custom))
+	{
+		return false;
+	}
+
+	USaveGameFunctionLibrary::SerializeActorTransform(Archive, this);
+
+	Archive.SerializeField(TEXT("Samples"), [this](FStructuredArchive::FSlot Slot)
+	{
+		Slot << Samples;
+	});
+
+	return true;
+}
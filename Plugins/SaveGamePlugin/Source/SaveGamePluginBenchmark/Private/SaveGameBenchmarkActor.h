@@ -0,0 +1,86 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "SaveGameObject.h"
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "SaveGameBenchmarkActor.generated.h"
+
+/** The groups of data that a benchmark actor can be filled with */
+UENUM(meta=(Bitflags, UseEnumValuesAsMaskValuesInEditor="true"))
+enum class ESaveGameBenchmarkProperties : uint8
+{
+	None = 0 UMETA(Hidden),
+	/** Numbers, booleans and vectors */
+	Scalars = 1 << 0,
+	/** Strings and names */
+	Strings = 1 << 1,
+	/** Arrays of numbers and vectors */
+	Arrays = 1 << 2,
+	/** Data written by OnSerialize, including the actor's transform */
+	Custom = 1 << 3,
+	All = Scalars | Strings | Arrays | Custom UMETA(Hidden),
+};
+ENUM_CLASS_FLAGS(ESaveGameBenchmarkProperties);
+
+/**
+ * A synthetic save game actor, spawned by USaveGameBenchmarkCommandlet.
+ * Its OnSerialize isn't thread-safe, so it is queued to the game thread (see ASaveGameBenchmarkThreadSafeActor).
+ */
+UCLASS(NotPlaceable, NotBlueprintable, HideDropdown)
+class ASaveGameBenchmarkActor : public AActor, public ISaveGameObject
+{
+	GENERATED_BODY()
+
+public:
+	ASaveGameBenchmarkActor();
+
+	/** Fills the given groups of data with random values, the rest are left as their defaults */
+	void Randomize(FRandomStream& Random, ESaveGameBenchmarkProperties InProperties);
+
+	virtual bool OnSerialize_Implementation(FSaveGameArchive& Archive, bool bIsLoading) override;
+
+private:
+	/** Which groups were filled, saved first so that OnSerialize reads back what was written */
+	UPROPERTY(SaveGame)
+	uint8 Properties = 0;
+
+	UPROPERTY(SaveGame)
+	int32 IntValue = 0;
+
+	UPROPERTY(SaveGame)
+	float FloatValue = 0.0f;
+
+	UPROPERTY(SaveGame)
+	bool bBoolValue = false;
+
+	UPROPERTY(SaveGame)
+	FVector VectorValue = FVector::ZeroVector;
+
+	UPROPERTY(SaveGame)
+	FString StringValue;
+
+	UPROPERTY(SaveGame)
+	FName NameValue;
+
+	UPROPERTY(SaveGame)
+	TArray<int32> IntArray;
+
+	UPROPERTY(SaveGame)
+	TArray<FVector> VectorArray;
+
+	/** Not a property, so it's only ever written by OnSerialize */
+	TArray<float> Samples;
+};
+
+/** The same as ASaveGameBenchmarkActor, but its OnSerialize can run on worker threads */
+UCLASS(NotPlaceable, NotBlueprintable, HideDropdown)
+class ASaveGameBenchmarkThreadSafeActor : public ASaveGameBenchmarkActor
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool IsThreadSafe_Implementation() const override { return true; }
+};
@@ -0,0 +1,545 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "SaveGameBenchmarkCommandlet.h"
+
+#include "SaveGameBenchmarkActor.h"
+#include "SaveGameBenchmarkStats.h"
+#include "SaveGameSerializer.h"
+#include "SaveGameSettings.h"
+#include "SaveGameSubsystem.h"
+
+#include "EngineUtils.h"
+#include "PlatformFeatures.h"
+#include "SaveGameSystem.h"
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSaveGameBenchmark, Log, All);
+
+namespace SaveGameBenchmark
+{
+	using namespace SaveGameBenchmarkStats;
+
+	const TCHAR* SlotName = TEXT("SaveGameBenchmark");
+
+	constexpr int32 NumPhases = static_cast<int32>(ESaveGamePhase::Cancelled) + 1;
+
+	/** The measurements of every recorded save (or load) at a single thread count */
+	struct FOperationSamples
+	{
+		TArray<double> TotalSeconds;
+		TArray<double> PhaseSeconds[NumPhases];
+		TArray<double> Allocations;
+		int64 UncompressedBytes = 0;
+	};
+
+	/** How much worse than the baseline each measurement can be before it's a regression, as a fraction of the baseline */
+	struct FTolerances
+	{
+		double Time = 0.25;
+
+		/** Added to the time tolerance, so that very short phases don't fail on noise */
+		double TimeSlackMs = 1.0;
+
+		double Size = 0.01;
+		double Allocations = 0.05;
+
+		void Read(const FJsonObject& Object)
+		{
+			Object.TryGetNumberField(TEXT("Time"), Time);
+			Object.TryGetNumberField(TEXT("TimeSlackMs"), TimeSlackMs);
+			Object.TryGetNumberField(TEXT("Size"), Size);
+			Object.TryGetNumberField(TEXT("Allocations"), Allocations);
+		}
+
+		TSharedRef<FJsonObject> ToJson() const
+		{
+			TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+			Object->SetNumberField(TEXT("Time"), Time);
+			Object->SetNumberField(TEXT("TimeSlackMs"), TimeSlackMs);
+			Object->SetNumberField(TEXT("Size"), Size);
+			Object->SetNumberField(TEXT("Allocations"), Allocations);
+			return Object;
+		}
+	};
+
+	ESaveGameBenchmarkProperties ParseProperties(const FString& PropertiesString)
+	{
+		const UEnum* PropertiesEnum = StaticEnum<ESaveGameBenchmarkProperties>();
+		ESaveGameBenchmarkProperties Properties = ESaveGameBenchmarkProperties::None;
+
+		TArray<FString> PropertyNames;
+		PropertiesString.ParseIntoArray(PropertyNames, TEXT("+"));
+
+		for (const FString& PropertyName : PropertyNames)
+		{
+			const int64 Value = PropertiesEnum->GetValueByNameString(PropertyName);
+
+			if (Value == INDEX_NONE)
+			{
+				UE_LOG(LogSaveGameBenchmark, Warning, TEXT("Unknown property group: %s"), *PropertyName);
+				continue;
+			}
+
+			Properties |= static_cast<ESaveGameBenchmarkProperties>(Value);
+		}
+
+		return Properties;
+	}
+
+	void SpawnActors(UWorld* World, int32 NumActors, float ThreadSafeRatio, ESaveGameBenchmarkProperties Properties, int32 Seed)
+	{
+		FRandomStream Random(Seed);
+		const int32 NumThreadSafeActors = FMath::RoundToInt(NumActors * FMath::Clamp(ThreadSafeRatio, 0.0f, 1.0f));
+
+		for (int32 ActorIdx = 0; ActorIdx < NumActors; ++ActorIdx)
+		{
+			UClass* ActorClass = ActorIdx < NumThreadSafeActors
+				? ASaveGameBenchmarkThreadSafeActor::StaticClass()
+				: ASaveGameBenchmarkActor::StaticClass();
+
+			ASaveGameBenchmarkActor* Actor = World->SpawnActor<ASaveGameBenchmarkActor>(ActorClass);
+			Actor->Randomize(Random, Properties);
+		}
+	}
+
+	/** Destroys every benchmark actor, so that the next load has to spawn them again */
+	void DestroyActors(UWorld* World)
+	{
+		TArray<ASaveGameBenchmarkActor*> Actors;
+		for (TActorIterator<ASaveGameBenchmarkActor> It(World); It; ++It)
+		{
+			Actors.Add(*It);
+		}
+
+		for (ASaveGameBenchmarkActor* Actor : Actors)
+		{
+			World->DestroyActor(Actor);
+		}
+
+		// Loading spawns actors with their saved names, which can't be done until the old actors are gone
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	void RunOperation(USaveGameSubsystem* Subsystem, bool bIsLoading, FOperationSamples* Samples)
+	{
+		TSharedRef<FSaveGameSerializer> Serializer = FSaveGameSerializer::Create(Subsystem, SlotName, bIsLoading);
+		Serializer->SetLoadInPlace(true);
+
+		const uint64 StartAllocations = GetNumAllocations();
+		const double StartTime = FPlatformTime::Seconds();
+		const UE::Tasks::FTask Task = Serializer->DoOperation();
+
+		// There's no engine loop in a commandlet, so pump the game thread tasks that the serializer queues
+		while (!Task.IsCompleted())
+		{
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+			FPlatformProcess::SleepNoStats(0.0f);
+		}
+
+		if (Samples)
+		{
+			Samples->TotalSeconds.Add(FPlatformTime::Seconds() - StartTime);
+			Samples->Allocations.Add(static_cast<double>(GetNumAllocations() - StartAllocations));
+
+			for (int32 PhaseIdx = 0; PhaseIdx < NumPhases; ++PhaseIdx)
+			{
+				Samples->PhaseSeconds[PhaseIdx].Add(Serializer->GetPhaseSeconds(static_cast<ESaveGamePhase>(PhaseIdx)));
+			}
+
+			Samples->UncompressedBytes = Serializer->GetUncompressedSize();
+		}
+	}
+
+	TSharedRef<FJsonObject> MakeLatencyObject(TArray<double> Seconds)
+	{
+		Seconds.Sort();
+
+		auto Percentile = [&Seconds](double Fraction)
+		{
+			const int32 Index = FMath::Clamp(FMath::CeilToInt(Fraction * Seconds.Num()) - 1, 0, Seconds.Num() - 1);
+			return Seconds[Index] * 1000.0;
+		};
+
+		TSharedRef<FJsonObject> Latency = MakeShared<FJsonObject>();
+		Latency->SetNumberField(TEXT("P50Ms"), Percentile(0.5));
+		Latency->SetNumberField(TEXT("P95Ms"), Percentile(0.95));
+		Latency->SetNumberField(TEXT("MaxMs"), Seconds.Last() * 1000.0);
+		return Latency;
+	}
+
+	TSharedRef<FJsonObject> MakeOperationObject(const FOperationSamples& Samples)
+	{
+		const UEnum* PhaseEnum = StaticEnum<ESaveGamePhase>();
+
+		TSharedRef<FJsonObject> Phases = MakeShared<FJsonObject>();
+		for (int32 PhaseIdx = 0; PhaseIdx < NumPhases; ++PhaseIdx)
+		{
+			// Only report the phases that this operation goes through
+			if (FMath::Max(Samples.PhaseSeconds[PhaseIdx]) > 0.0)
+			{
+				Phases->SetObjectField(PhaseEnum->GetNameStringByValue(PhaseIdx), MakeLatencyObject(Samples.PhaseSeconds[PhaseIdx]));
+			}
+		}
+
+		const double MedianSeconds = GetMedian(Samples.TotalSeconds);
+
+		TSharedRef<FJsonObject> Operation = MakeShared<FJsonObject>();
+		Operation->SetObjectField(TEXT("Total"), MakeLatencyObject(Samples.TotalSeconds));
+		Operation->SetObjectField(TEXT("Phases"), Phases);
+		Operation->SetNumberField(TEXT("UncompressedBytes"), Samples.UncompressedBytes);
+		Operation->SetNumberField(TEXT("Allocations"), GetMedian(Samples.Allocations));
+		Operation->SetNumberField(TEXT("MBPerSecond"), MedianSeconds > 0.0 ? Samples.UncompressedBytes / (1024.0 * 1024.0) / MedianSeconds : 0.0);
+		return Operation;
+	}
+
+	/** Compares a report against a baseline report of the same world, logging an error for each regression */
+	class FRegressionCheck
+	{
+	public:
+		FRegressionCheck(const FTolerances& InTolerances, bool bInCompareTimes)
+			: Tolerances(InTolerances)
+			, bCompareTimes(bInCompareTimes)
+		{}
+
+		void CheckReport(const FJsonObject& Report, const FJsonObject& Baseline)
+		{
+			const TArray<TSharedPtr<FJsonValue>>& BaselineRuns = Baseline.GetArrayField(TEXT("Runs"));
+
+			if (BaselineRuns.IsEmpty())
+			{
+				Fail(TEXT("The baseline doesn't have any measurements yet, they can be recorded with -UpdateBaseline"));
+				return;
+			}
+
+			// A build without stats can't count allocations, which would otherwise look like there weren't any
+			bool bBaselineCountedAllocations = true;
+			Baseline.TryGetBoolField(TEXT("AllocationsCounted"), bBaselineCountedAllocations);
+			bCompareAllocations = bBaselineCountedAllocations && Report.GetBoolField(TEXT("AllocationsCounted"));
+
+			if (bBaselineCountedAllocations && !bCompareAllocations)
+			{
+				Fail(TEXT("Allocations can't be counted without stats, so can't be compared against the baseline"));
+			}
+			else if (!bBaselineCountedAllocations)
+			{
+				UE_LOG(LogSaveGameBenchmark, Warning, TEXT("The baseline was recorded without stats, so allocations aren't compared"));
+			}
+
+			for (const TSharedPtr<FJsonValue>& BaselineRunValue : BaselineRuns)
+			{
+				const TSharedPtr<FJsonObject>& BaselineRun = BaselineRunValue->AsObject();
+				const int32 NumThreads = BaselineRun->GetIntegerField(TEXT("Threads"));
+
+				const TSharedPtr<FJsonValue>* Run = Report.GetArrayField(TEXT("Runs")).FindByPredicate([NumThreads](const TSharedPtr<FJsonValue>& RunValue)
+				{
+					return RunValue->AsObject()->GetIntegerField(TEXT("Threads")) == NumThreads;
+				});
+
+				const FString Prefix = FString::Printf(TEXT("Threads=%d"), NumThreads);
+
+				if (!Run)
+				{
+					Fail(FString::Printf(TEXT("%s wasn't measured, but is in the baseline"), *Prefix));
+					continue;
+				}
+
+				const FJsonObject& RunObject = *(*Run)->AsObject();
+				Check(Prefix + TEXT(".FileBytes"), RunObject.GetNumberField(TEXT("FileBytes")), BaselineRun->GetNumberField(TEXT("FileBytes")), Tolerances.Size);
+
+				for (const TCHAR* Operation : { TEXT("Save"), TEXT("Load") })
+				{
+					CheckOperation(Prefix + TEXT(".") + Operation, *RunObject.GetObjectField(Operation), *BaselineRun->GetObjectField(Operation));
+				}
+			}
+		}
+
+		int32 GetNumRegressions() const { return NumRegressions; }
+
+	private:
+		void CheckOperation(const FString& Prefix, const FJsonObject& Operation, const FJsonObject& Baseline)
+		{
+			if (bCompareTimes)
+			{
+				CheckTime(Prefix + TEXT(".Total"), *Operation.GetObjectField(TEXT("Total")), *Baseline.GetObjectField(TEXT("Total")));
+
+				const TSharedPtr<FJsonObject>& Phases = Operation.GetObjectField(TEXT("Phases"));
+				for (const TPair<FString, TSharedPtr<FJsonValue>>& BaselinePhase : Baseline.GetObjectField(TEXT("Phases"))->Values)
+				{
+					const TSharedPtr<FJsonObject>* Phase;
+					if (Phases->TryGetObjectField(BaselinePhase.Key, Phase))
+					{
+						CheckTime(Prefix + TEXT(".") + BaselinePhase.Key, **Phase, *BaselinePhase.Value->AsObject());
+					}
+				}
+			}
+
+			Check(Prefix + TEXT(".UncompressedBytes"), Operation.GetNumberField(TEXT("UncompressedBytes")), Baseline.GetNumberField(TEXT("UncompressedBytes")), Tolerances.Size);
+
+			if (bCompareAllocations)
+			{
+				Check(Prefix + TEXT(".Allocations"), Operation.GetNumberField(TEXT("Allocations")), Baseline.GetNumberField(TEXT("Allocations")), Tolerances.Allocations);
+			}
+		}
+
+		void CheckTime(const FString& Metric, const FJsonObject& Latency, const FJsonObject& BaselineLatency)
+		{
+			// The median is used, as the tail is too noisy on shared machines
+			Check(Metric + TEXT(".P50Ms"), Latency.GetNumberField(TEXT("P50Ms")), BaselineLatency.GetNumberField(TEXT("P50Ms")), Tolerances.Time, Tolerances.TimeSlackMs);
+		}
+
+		void Check(const FString& Metric, double Value, double BaselineValue, double Tolerance, double Slack = 0.0)
+		{
+			if (Value > BaselineValue * (1.0 + Tolerance) + Slack)
+			{
+				Fail(FString::Printf(TEXT("%s regressed: %.3f, baseline is %.3f (+%.0f%%)"), *Metric, Value, BaselineValue, Tolerance * 100.0));
+			}
+			else if (Value < BaselineValue * (1.0 - Tolerance) - Slack)
+			{
+				UE_LOG(LogSaveGameBenchmark, Display, TEXT("%s improved: %.3f, baseline is %.3f, consider updating the baseline"), *Metric, Value, BaselineValue);
+			}
+		}
+
+		void Fail(const FString& Message)
+		{
+			UE_LOG(LogSaveGameBenchmark, Error, TEXT("%s"), *Message);
+			++NumRegressions;
+		}
+
+		const FTolerances& Tolerances;
+
+		/** Times depend on the machine, so a baseline that's shared between machines only compares sizes and allocations */
+		const bool bCompareTimes;
+		bool bCompareAllocations = true;
+
+		int32 NumRegressions = 0;
+	};
+}
+
+USaveGameBenchmarkCommandlet::USaveGameBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 USaveGameBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace SaveGameBenchmark;
+
+	ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	IConsoleVariable* MaxWorkerThreadsVariable = IConsoleManager::Get().FindConsoleVariable(TEXT("SaveGame.MaxWorkerThreads"));
+
+	if (!SaveSystem || !GThreadPool || !MaxWorkerThreadsVariable)
+	{
+		UE_LOG(LogSaveGameBenchmark, Error, TEXT("The save game system and thread pool are required to run the benchmark"));
+		return 1;
+	}
+
+	int32 NumActors = 1000;
+	int32 NumIterations = 5;
+	float ThreadSafeRatio = 0.5f;
+	int32 MaxThreads = GThreadPool->GetNumThreads();
+	int32 Seed = 0;
+	FString PropertiesString = TEXT("Scalars+Strings+Arrays+Custom");
+	FString ActorOrderString = StaticEnum<ESaveGameActorOrder>()->GetNameStringByValue(static_cast<int64>(GetDefault<USaveGameSettings>()->ActorOrder));
+	FString OutputPath = FPaths::ProfilingDir() / TEXT("SaveGame") / TEXT("Benchmark.json");
+
+	FParse::Value(*Params, TEXT("Actors="), NumActors);
+	FParse::Value(*Params, TEXT("Iterations="), NumIterations);
+	FParse::Value(*Params, TEXT("ThreadSafeRatio="), ThreadSafeRatio);
+	FParse::Value(*Params, TEXT("MaxThreads="), MaxThreads);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Properties="), PropertiesString);
+	FParse::Value(*Params, TEXT("ActorOrder="), ActorOrderString);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	FString BaselinePath;
+	const bool bUseBaseline = FParse::Value(*Params, TEXT("Baseline="), BaselinePath);
+	const bool bUpdateBaseline = bUseBaseline && FParse::Param(*Params, TEXT("UpdateBaseline"));
+
+	FTolerances Tolerances;
+	bool bCompareTimes = true;
+	TSharedPtr<FJsonObject> Baseline;
+
+	if (bUseBaseline)
+	{
+		FString BaselineString;
+		if (FFileHelper::LoadFileToString(BaselineString, *BaselinePath))
+		{
+			FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineString), Baseline);
+		}
+
+		if (Baseline.IsValid())
+		{
+			const TSharedPtr<FJsonObject>* TolerancesObject;
+			if (Baseline->TryGetObjectField(TEXT("Tolerances"), TolerancesObject))
+			{
+				Tolerances.Read(**TolerancesObject);
+			}
+
+			Baseline->TryGetBoolField(TEXT("CompareTimes"), bCompareTimes);
+
+			// The baseline describes the world that it was measured with, so that we measure (or re-record) the same world
+			double BaselineThreadSafeRatio = ThreadSafeRatio;
+			Baseline->TryGetNumberField(TEXT("Actors"), NumActors);
+			Baseline->TryGetNumberField(TEXT("Iterations"), NumIterations);
+			Baseline->TryGetNumberField(TEXT("ThreadSafeRatio"), BaselineThreadSafeRatio);
+			Baseline->TryGetNumberField(TEXT("MaxThreads"), MaxThreads);
+			Baseline->TryGetNumberField(TEXT("Seed"), Seed);
+			Baseline->TryGetStringField(TEXT("Properties"), PropertiesString);
+			Baseline->TryGetStringField(TEXT("ActorOrder"), ActorOrderString);
+			ThreadSafeRatio = BaselineThreadSafeRatio;
+		}
+		else if (!bUpdateBaseline)
+		{
+			UE_LOG(LogSaveGameBenchmark, Error, TEXT("Failed to read the baseline %s, it can be recorded with -UpdateBaseline"), *BaselinePath);
+			return 1;
+		}
+	}
+
+	NumActors = FMath::Max(NumActors, 1);
+	NumIterations = FMath::Max(NumIterations, 1);
+	MaxThreads = FMath::Clamp(MaxThreads, 1, GThreadPool->GetNumThreads());
+
+	const ESaveGameBenchmarkProperties Properties = ParseProperties(PropertiesString);
+
+	const int64 ActorOrder = StaticEnum<ESaveGameActorOrder>()->GetValueByNameString(ActorOrderString);
+	if (ActorOrder == INDEX_NONE)
+	{
+		UE_LOG(LogSaveGameBenchmark, Error, TEXT("Unknown actor order: %s"), *ActorOrderString);
+		return 1;
+	}
+
+	USaveGameSettings* Settings = GetMutableDefault<USaveGameSettings>();
+	const ESaveGameActorOrder PreviousActorOrder = Settings->ActorOrder;
+	Settings->ActorOrder = static_cast<ESaveGameActorOrder>(ActorOrder);
+
+	// An empty world, with the game instance's subsystems initialized as they would be in a game
+	UGameInstance* GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->AddToRoot();
+	GameInstance->InitializeStandalone();
+
+	UWorld* World = GameInstance->GetWorld();
+	USaveGameSubsystem* Subsystem = GameInstance->GetSubsystem<USaveGameSubsystem>();
+	check(World && Subsystem);
+
+	SpawnActors(World, NumActors, ThreadSafeRatio, Properties, Seed);
+
+	TArray<int32> ThreadCounts;
+	for (int32 NumThreads = 1; NumThreads < MaxThreads; NumThreads *= 2)
+	{
+		ThreadCounts.Add(NumThreads);
+	}
+	ThreadCounts.Add(MaxThreads);
+
+	const int32 PreviousMaxWorkerThreads = MaxWorkerThreadsVariable->GetInt();
+	TArray<TSharedPtr<FJsonValue>> Runs;
+
+	for (const int32 NumThreads : ThreadCounts)
+	{
+		MaxWorkerThreadsVariable->Set(NumThreads, ECVF_SetByCode);
+
+		FOperationSamples SaveSamples;
+		FOperationSamples LoadSamples;
+
+		// The first iteration warms up class traits, name tables and allocators, so isn't recorded
+		for (int32 Iteration = 0; Iteration <= NumIterations; ++Iteration)
+		{
+			const bool bRecord = Iteration > 0;
+
+			RunOperation(Subsystem, false, bRecord ? &SaveSamples : nullptr);
+			DestroyActors(World);
+			RunOperation(Subsystem, true, bRecord ? &LoadSamples : nullptr);
+		}
+
+		TArray<uint8> FileData;
+		SaveSystem->LoadGame(false, SlotName, 0, FileData);
+
+		// The process' peak, so this includes every thread count that's been measured so far
+		const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+		TSharedRef<FJsonObject> Run = MakeShared<FJsonObject>();
+		Run->SetNumberField(TEXT("Threads"), NumThreads);
+		Run->SetNumberField(TEXT("FileBytes"), FileData.Num());
+		Run->SetNumberField(TEXT("CompressionRatio"), FileData.Num() > 0 ? static_cast<double>(SaveSamples.UncompressedBytes) / FileData.Num() : 0.0);
+		Run->SetNumberField(TEXT("PeakUsedPhysicalMB"), MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0));
+		Run->SetObjectField(TEXT("Save"), MakeOperationObject(SaveSamples));
+		Run->SetObjectField(TEXT("Load"), MakeOperationObject(LoadSamples));
+		Runs.Add(MakeShared<FJsonValueObject>(Run));
+
+		UE_LOG(LogSaveGameBenchmark, Display, TEXT("Measured %d actors with %d threads"), NumActors, NumThreads);
+	}
+
+	MaxWorkerThreadsVariable->Set(PreviousMaxWorkerThreads, ECVF_SetByCode);
+	Settings->ActorOrder = PreviousActorOrder;
+
+	SaveSystem->DeleteGame(false, SlotName, 0);
+	SaveSystem->DeleteGame(false, *(FString(SlotName) + TEXT(".json")), 0);
+
+	GameInstance->Shutdown();
+	GameInstance->RemoveFromRoot();
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetNumberField(TEXT("Actors"), NumActors);
+	Report->SetNumberField(TEXT("Iterations"), NumIterations);
+	Report->SetNumberField(TEXT("ThreadSafeRatio"), ThreadSafeRatio);
+	Report->SetNumberField(TEXT("MaxThreads"), MaxThreads);
+	Report->SetNumberField(TEXT("Seed"), Seed);
+	Report->SetStringField(TEXT("Properties"), PropertiesString);
+	Report->SetStringField(TEXT("ActorOrder"), ActorOrderString);
+	Report->SetBoolField(TEXT("JsonOutput"), WITH_TEXT_ARCHIVE_SUPPORT != 0);
+	Report->SetBoolField(TEXT("AllocationsCounted"), bCountsAllocations);
+	Report->SetArrayField(TEXT("Runs"), Runs);
+
+	FString ReportString;
+	FJsonSerializer::Serialize(Report, TJsonWriterFactory<>::Create(&ReportString));
+
+	if (!FFileHelper::SaveStringToFile(ReportString, *OutputPath))
+	{
+		UE_LOG(LogSaveGameBenchmark, Error, TEXT("Failed to write the report to %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogSaveGameBenchmark, Display, TEXT("Wrote the report to %s"), *OutputPath);
+
+	if (bUpdateBaseline)
+	{
+		Report->SetObjectField(TEXT("Tolerances"), Tolerances.ToJson());
+		Report->SetBoolField(TEXT("CompareTimes"), bCompareTimes);
+
+		FString BaselineString;
+		FJsonSerializer::Serialize(Report, TJsonWriterFactory<>::Create(&BaselineString));
+
+		if (!FFileHelper::SaveStringToFile(BaselineString, *BaselinePath))
+		{
+			UE_LOG(LogSaveGameBenchmark, Error, TEXT("Failed to write the baseline to %s"), *BaselinePath);
+			return 1;
+		}
+
+		UE_LOG(LogSaveGameBenchmark, Display, TEXT("Updated the baseline %s"), *BaselinePath);
+	}
+	else if (Baseline.IsValid())
+	{
+		FRegressionCheck RegressionCheck(Tolerances, bCompareTimes);
+		RegressionCheck.CheckReport(*Report, *Baseline);
+
+		if (RegressionCheck.GetNumRegressions() > 0)
+		{
+			UE_LOG(LogSaveGameBenchmark, Error, TEXT("%d measurements regressed against the baseline %s"), RegressionCheck.GetNumRegressions(), *BaselinePath);
+			return 1;
+		}
+
+		UE_LOG(LogSaveGameBenchmark, Display, TEXT("No regressions against the baseline %s"), *BaselinePath);
+	}
+
+	return 0;
+}
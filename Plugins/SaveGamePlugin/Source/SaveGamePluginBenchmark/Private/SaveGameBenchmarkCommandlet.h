@@ -0,0 +1,47 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SaveGameBenchmarkCommandlet.generated.h"
+
+/**
+ * Measures save and load throughput without a map or a GPU, for repeatable numbers on build machines:
+ *
+ *		UnrealEditor-Cmd SaveGame.uproject -run=SaveGameBenchmark -nullrhi -unattended
+ *
+ * Spawns a number of ASaveGameBenchmarkActors into an empty world, then saves and loads them several times at each
+ * worker thread count (1, 2, 4... up to MaxThreads). Loads happen in place (the actors are destroyed first, so they
+ * are respawned by the load), as there's no map to travel to. The results are written as JSON.
+ *
+ * With -Baseline, the results are compared against a checked-in baseline report (measuring the same world that the
+ * baseline was measured with), and the commandlet fails if the time per phase, sizes or allocations have regressed by
+ * more than the baseline's tolerances. The baseline can be recorded (or re-recorded) by adding -UpdateBaseline.
+ * Baselines with "CompareTimes": false only compare sizes and allocations, so they can be shared between machines,
+ * like the plugin's Resources/SaveGameBenchmarkBaseline.json. The SaveGamePlugin.Benchmark.Regression automation test
+ * runs this commandlet against it in a separate process, once it has been recorded. Allocations are only compared when
+ * both the baseline and this build count them (with stats).
+ *
+ * Parameters:
+ *		-Actors=1000					Number of actors to spawn
+ *		-Iterations=5					Number of recorded saves and loads at each thread count, after one warm up
+ *		-Properties=Scalars+Strings+Arrays+Custom	Which groups of data the actors are filled with
+ *		-ThreadSafeRatio=0.5			The fraction of actors whose OnSerialize can run on worker threads
+ *		-MaxThreads=N					The most worker threads to measure, defaults to the size of the thread pool
+ *		-Seed=0							Seeds the actors' random values
+ *		-ActorOrder=Clustered			Overrides USaveGameSettings::ActorOrder, to compare each order's size and time
+ *		-Output=Path.json				Defaults to Saved/Profiling/SaveGame/Benchmark.json
+ *		-Baseline=Path.json				Compares the results against this baseline
+ *		-UpdateBaseline					Writes the results to the baseline, rather than comparing against it
+ */
+UCLASS()
+class USaveGameBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USaveGameBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
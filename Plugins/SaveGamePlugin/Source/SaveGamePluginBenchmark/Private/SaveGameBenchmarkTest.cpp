@@ -0,0 +1,74 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformProcess.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSaveGameBenchmarkRegressionTest, "SaveGamePlugin.Benchmark.Regression",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FSaveGameBenchmarkRegressionTest::RunTest(const FString& Parameters)
+{
+	const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("SaveGamePlugin"));
+	if (!TestNotNull(TEXT("SaveGamePlugin"), Plugin.Get()))
+	{
+		return false;
+	}
+
+	const FString BaselinePath = FPaths::ConvertRelativePathToFull(Plugin->GetBaseDir() / TEXT("Resources/SaveGameBenchmarkBaseline.json"));
+
+	FString BaselineString;
+	TSharedPtr<FJsonObject> Baseline;
+	if (!TestTrue(TEXT("Baseline exists"), FFileHelper::LoadFileToString(BaselineString, *BaselinePath))
+		|| !TestTrue(TEXT("Baseline is valid"), FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineString), Baseline) && Baseline.IsValid()))
+	{
+		return false;
+	}
+
+	// There's nothing to compare against until the baseline has been recorded on a machine with stats enabled
+	const TArray<TSharedPtr<FJsonValue>>* BaselineRuns;
+	if (!Baseline->TryGetArrayField(TEXT("Runs"), BaselineRuns) || BaselineRuns->IsEmpty())
+	{
+		AddWarning(FString::Printf(TEXT("Skipped, as the baseline hasn't been recorded yet. Record it with: -run=SaveGameBenchmark -Baseline=\"%s\" -UpdateBaseline"), *BaselinePath));
+		return true;
+	}
+
+	// The commandlet creates its own game instance and world, changes settings and collects garbage, so it can't share the editor
+	const FString ExecutablePath = FPlatformProcess::GenerateApplicationPath(TEXT("UnrealEditor-Cmd"), FApp::GetBuildConfiguration());
+	const FString LogPath = FPaths::ConvertRelativePathToFull(FPaths::ProjectLogDir() / TEXT("SaveGameBenchmark.log"));
+	const FString Arguments = FString::Printf(TEXT("\"%s\" -run=SaveGameBenchmark -Baseline=\"%s\" -abslog=\"%s\" -nullrhi -unattended -nopause -nosplash"),
+		*FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath()), *BaselinePath, *LogPath);
+
+	FProcHandle Process = FPlatformProcess::CreateProc(*ExecutablePath, *Arguments, false, true, true, nullptr, 0, nullptr, nullptr);
+	if (!TestTrue(TEXT("Started the benchmark commandlet"), Process.IsValid()))
+	{
+		return false;
+	}
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Process, LogPath]() mutable
+	{
+		if (FPlatformProcess::IsProcRunning(Process))
+		{
+			return false;
+		}
+
+		int32 ReturnCode = INDEX_NONE;
+		FPlatformProcess::GetProcReturnCode(Process, &ReturnCode);
+		FPlatformProcess::CloseProc(Process);
+
+		// Each regression is logged as an error by the commandlet
+		TestEqual(FString::Printf(TEXT("Benchmark commandlet exit code (see %s)"), *LogPath), ReturnCode, 0);
+		return true;
+	}));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,5 @@
+#include "SaveGamePluginBenchmark.h"
+
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, SaveGamePluginBenchmark)
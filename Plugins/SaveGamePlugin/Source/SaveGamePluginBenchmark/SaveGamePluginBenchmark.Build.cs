@@ -0,0 +1,33 @@
+// Copyright Alex Stevens (@MilkyEngineer). All Rights Reserved.
+
+using System.IO;
+using UnrealBuildTool;
+
+public class SaveGamePluginBenchmark : ModuleRules
+{
+    public SaveGamePluginBenchmark(ReadOnlyTargetRules Target) : base(Target)
+    {
+        PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+        // The benchmark drives the serializer directly, which isn't part of the plugin's public API
+        PrivateIncludePaths.Add(Path.Combine(ModuleDirectory, "..", "SaveGamePlugin", "Private"));
+
+        PublicDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "Core",
+            }
+        );
+
+        PrivateDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "SaveGamePlugin",
+                "CoreUObject",
+                "Engine",
+                "Json",
+                "Projects",
+            }
+        );
+    }
+}